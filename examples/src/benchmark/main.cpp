@@ -0,0 +1,297 @@
+// Host micro-benchmarks of the protocol hot paths, results are written to stdout as JSON
+#include <modm-canopen/canopen_device.hpp>
+#include <modm-canopen/constexpr_map.hpp>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+using modm_canopen::AccessType;
+using modm_canopen::Address;
+using modm_canopen::CanopenDevice;
+using modm_canopen::ConstexprMapBuilder;
+using modm_canopen::DataType;
+using modm_canopen::Entry;
+using modm_canopen::HandlerMap;
+using modm_canopen::SdoErrorCode;
+using modm_canopen::generated::DefaultObjects;
+
+constexpr std::size_t ValueCount = 8;
+std::array<uint32_t, ValueCount> transmitValues{};
+std::array<uint32_t, ValueCount> receiveValues{};
+
+struct BenchmarkObjects
+{
+    template<typename ObjectDictionary>
+    constexpr void registerHandlers(HandlerMap<ObjectDictionary>& map)
+    {
+        registerValues(map, std::make_index_sequence<ValueCount>{});
+    }
+
+private:
+    template<typename ObjectDictionary, std::size_t... i>
+    constexpr void registerValues(HandlerMap<ObjectDictionary>& map, std::index_sequence<i...>)
+    {
+        // 0x2100-0x2107: TPDO mappable, 0x2200-0x2207: RPDO mappable
+        (map.template setReadHandler<Address{0x2100 + i, 0}>(
+            +[]() { return transmitValues[i]; }), ...);
+        (map.template setWriteHandler<Address{0x2100 + i, 0}>(
+            +[](uint32_t value) { transmitValues[i] = value; return SdoErrorCode::NoError; }), ...);
+        (map.template setReadHandler<Address{0x2200 + i, 0}>(
+            +[]() { return receiveValues[i]; }), ...);
+        (map.template setWriteHandler<Address{0x2200 + i, 0}>(
+            +[](uint32_t value) { receiveValues[i] = value; return SdoErrorCode::NoError; }), ...);
+    }
+};
+
+using Device = CanopenDevice<DefaultObjects, BenchmarkObjects>;
+constexpr uint8_t NodeId = 5;
+
+std::size_t sentFrames = 0;
+const auto countFrame = [](const modm::can::Message&) { ++sentFrames; };
+
+struct Result
+{
+    std::string name;
+    std::size_t parameter;
+    std::size_t iterations;
+    double nsPerOp;
+    double nsPerOpMedian;
+};
+
+std::vector<Result> results;
+
+/// Run function(i) for i in [0, iterations) several times, record minimum and median time
+template<typename Function>
+void measure(std::string name, std::size_t parameter, std::size_t iterations, Function&& function)
+{
+    constexpr std::size_t Runs = 7;
+    std::array<double, Runs> nsPerOp{};
+    for (auto& result : nsPerOp) {
+        const auto start = std::chrono::steady_clock::now();
+        for (std::size_t i = 0; i < iterations; ++i) {
+            function(i);
+        }
+        const std::chrono::duration<double, std::nano> duration = std::chrono::steady_clock::now() - start;
+        result = duration.count() / iterations;
+    }
+    std::sort(nsPerOp.begin(), nsPerOp.end());
+    results.push_back(Result{std::move(name), parameter, iterations, nsPerOp.front(), nsPerOp[Runs / 2]});
+}
+
+modm::can::Message makeMessage(uint32_t identifier, std::initializer_list<uint8_t> data)
+{
+    modm::can::Message message{identifier, uint8_t(data.size())};
+    message.setExtended(false);
+    std::copy(data.begin(), data.end(), message.data);
+    return message;
+}
+
+modm::can::Message sdoDownload(Address address, uint32_t value, uint8_t size)
+{
+    const uint8_t command = 0x23 | ((4 - size) << 2);
+    return makeMessage(0x600 + NodeId, {command, uint8_t(address.index), uint8_t(address.index >> 8),
+        address.subindex, uint8_t(value), uint8_t(value >> 8), uint8_t(value >> 16), uint8_t(value >> 24)});
+}
+
+modm::can::Message sdoUpload(Address address)
+{
+    return makeMessage(0x600 + NodeId, {0x40, uint8_t(address.index), uint8_t(address.index >> 8),
+        address.subindex, 0, 0, 0, 0});
+}
+
+/// Configure the device through SDO, exit on errors
+void configure(Address address, uint32_t value, uint8_t size = 4)
+{
+    bool success = false;
+    Device::processMessage(sdoDownload(address, value, size), [&success](const modm::can::Message& response) {
+        success = (response.data[0] == 0x60);
+    });
+    if (!success) {
+        std::fprintf(stderr, "Configuring 0x%04x:%d failed\n", address.index, address.subindex);
+        std::exit(1);
+    }
+}
+
+constexpr uint32_t transmitPdoCanId(uint16_t pdo) { return 0x190 + pdo; }
+
+/// Map 0x2100 and the TPDO specific value into the first count TPDOs, disable the others
+void setupTransmitPdos(uint16_t count)
+{
+    for (uint16_t pdo = 0; pdo < Device::TransmitPdoCount; ++pdo) {
+        configure(Address{uint16_t(0x1800 + pdo), 1}, transmitPdoCanId(pdo) | 0x8000'0000);
+    }
+    for (uint16_t pdo = 0; pdo < count; ++pdo) {
+        const uint16_t value = 0x2100 + 1 + (pdo % (ValueCount - 1));
+        configure(Address{uint16_t(0x1A00 + pdo), 0}, 0, 1);
+        configure(Address{uint16_t(0x1A00 + pdo), 1}, 0x2100'0020);
+        configure(Address{uint16_t(0x1A00 + pdo), 2}, (uint32_t(value) << 16) | 0x20);
+        configure(Address{uint16_t(0x1A00 + pdo), 0}, 2, 1);
+        configure(Address{uint16_t(0x1800 + pdo), 1}, transmitPdoCanId(pdo));
+    }
+}
+
+void benchmarkProcessMessage()
+{
+    constexpr std::size_t Iterations = 1'000'000;
+
+    // RPDO1 with two mapped 32 bit values
+    configure(Address{0x1600, 0}, 0, 1);
+    configure(Address{0x1600, 1}, 0x2200'0020);
+    configure(Address{0x1600, 2}, 0x2201'0020);
+    configure(Address{0x1600, 0}, 2, 1);
+    configure(Address{0x1400, 1}, 0x200 + NodeId);
+
+    const auto rpdo = makeMessage(0x200 + NodeId, {1, 2, 3, 4, 5, 6, 7, 8});
+    measure("process_message_rpdo", 1, Iterations, [&rpdo](std::size_t) {
+        Device::processMessage(rpdo, countFrame);
+    });
+
+    // same RPDO delivered to one frame handler instead of two write handlers
+    Device::setReceivePdoFrameHandler(0, +[](void*, const modm_canopen::ReceivePdoFrame& frame) {
+        receiveValues[0] = std::get<uint32_t>(frame.values[0]);
+        receiveValues[1] = std::get<uint32_t>(frame.values[1]);
+    });
+    const modm::PreciseTimestamp timestamp{};
+    measure("process_message_rpdo_frame", 1, Iterations, [&rpdo, &timestamp](std::size_t) {
+        Device::processMessage(rpdo, timestamp, countFrame);
+    });
+    Device::setReceivePdoFrameHandler(0, nullptr);
+
+    const auto upload = sdoUpload(Address{0x2100, 0});
+    measure("process_message_sdo_upload", 1, Iterations, [&upload](std::size_t) {
+        Device::processMessage(upload, countFrame);
+    });
+
+    const auto download = sdoDownload(Address{0x2200, 0}, 0x1234'5678, 4);
+    measure("process_message_sdo_download", 1, Iterations, [&download](std::size_t) {
+        Device::processMessage(download, countFrame);
+    });
+
+    // TPDOs of other nodes, not consumed by this node
+    std::array<modm::can::Message, 126> foreign{};
+    for (std::size_t i = 0; i < foreign.size(); ++i) {
+        foreign[i] = makeMessage(0x181 + i, {1, 2, 3, 4, 5, 6, 7, 8});
+    }
+    measure("process_message_foreign", 1, Iterations, [&foreign](std::size_t i) {
+        Device::processMessage(foreign[i % foreign.size()], countFrame);
+    });
+}
+
+void benchmarkTransmitPdos()
+{
+    constexpr std::size_t Iterations = 200'000;
+    const Address mapped{0x2100, 0};
+    const Address unmapped{0x2200, 0};
+
+    for (uint16_t count = 1; count <= Device::TransmitPdoCount; count *= 2) {
+        setupTransmitPdos(count);
+        Device::update(countFrame);
+
+        measure("update_idle", count, Iterations, [](std::size_t) {
+            Device::update(countFrame);
+        });
+
+        // every update() transmits all active TPDOs
+        measure("update_all_due", count, Iterations, [mapped](std::size_t) {
+            Device::setValueChanged(mapped);
+            Device::update(countFrame);
+        });
+
+        measure("set_value_changed_mapped", count, Iterations, [mapped](std::size_t) {
+            Device::setValueChanged(mapped);
+        });
+        Device::update(countFrame);
+
+        measure("set_value_changed_unmapped", count, Iterations, [unmapped](std::size_t) {
+            Device::setValueChanged(unmapped);
+        });
+    }
+    setupTransmitPdos(0);
+}
+
+/// Synthetic dictionary with records of 16 sub-indices
+template<std::size_t Size>
+constexpr auto makeDictionary()
+{
+    ConstexprMapBuilder<Address, Entry, Size> builder{};
+    for (std::size_t i = 0; i < Size; ++i) {
+        const Address address{uint16_t(0x2000 + i / 16), uint8_t(i % 16)};
+        builder.insert(address, Entry{
+            .address    = address,
+            .dataType   = DataType::UInt32,
+            .accessType = AccessType::ReadWrite,
+            .pdoMapping = false
+        });
+    }
+    return builder.buildMap();
+}
+
+template<typename Map>
+void benchmarkLookup(const Map& map, std::size_t parameter, std::size_t& found)
+{
+    constexpr std::size_t Iterations = 1'000'000;
+
+    std::vector<Address> hits;
+    for (const auto& [address, entry] : map) {
+        hits.push_back(address);
+    }
+    std::shuffle(hits.begin(), hits.end(), std::mt19937{42});
+    measure("constexpr_map_lookup_hit", parameter, Iterations, [&map, &hits, &found](std::size_t i) {
+        found += bool(map.lookup(hits[i % hits.size()]));
+    });
+
+    std::vector<Address> misses;
+    for (const auto& address : hits) {
+        misses.push_back(Address{uint16_t(address.index + 0x3000), address.subindex});
+    }
+    measure("constexpr_map_lookup_miss", parameter, Iterations, [&map, &misses, &found](std::size_t i) {
+        found += bool(map.lookup(misses[i % misses.size()]));
+    });
+}
+
+template<std::size_t Size>
+struct SyntheticDictionary
+{
+    static constexpr auto map = makeDictionary<Size>();
+};
+
+void printJson(std::size_t sink)
+{
+    std::printf("{\n  \"library\": \"modm-canopen\",\n  \"unit\": \"ns\",\n  \"sink\": %zu,\n", sink);
+    std::printf("  \"benchmarks\": [\n");
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        const auto& result = results[i];
+        std::printf("    {\"name\": \"%s\", \"parameter\": %zu, \"iterations\": %zu, "
+                    "\"ns_per_op\": %.2f, \"ns_per_op_median\": %.2f}%s\n",
+                    result.name.c_str(), result.parameter, result.iterations,
+                    result.nsPerOp, result.nsPerOpMedian, (i + 1 < results.size()) ? "," : "");
+    }
+    std::printf("  ]\n}\n");
+}
+
+int main()
+{
+    Device::initialize(NodeId);
+
+    benchmarkProcessMessage();
+    benchmarkTransmitPdos();
+
+    std::size_t found = 0;
+    benchmarkLookup(DefaultObjects::map, DefaultObjects::map.size(), found);
+    benchmarkLookup(SyntheticDictionary<100>::map, 100, found);
+    benchmarkLookup(SyntheticDictionary<500>::map, 500, found);
+    benchmarkLookup(SyntheticDictionary<1000>::map, 1000, found);
+    benchmarkLookup(SyntheticDictionary<2000>::map, 2000, found);
+    benchmarkLookup(SyntheticDictionary<5000>::map, 5000, found);
+
+    // frame and lookup counts keep the measured calls from being optimized away
+    printJson(sentFrames + found + receiveValues[0]);
+    return 0;
+}
@@ -1,8 +1,7 @@
 #include <modm-canopen/canopen_device.hpp>
-#include <modm/platform/can/socketcan.hpp>
+#include <modm-canopen/socketcan_transport.hpp>
 
 #include <iostream>
-#include <thread>
 #include <modm/debug/logger.hpp>
 
 uint32_t value2002 = 42;
@@ -10,6 +9,7 @@ uint32_t value2002 = 42;
 using modm_canopen::Address;
 using modm_canopen::CanopenDevice;
 using modm_canopen::SdoErrorCode;
+using modm_canopen::SocketCanTransport;
 using modm_canopen::generated::DefaultObjects;
 
 struct Test
@@ -39,23 +39,20 @@ int main()
     const uint8_t nodeId = 5;
     Device::initialize(nodeId);
 
-    modm::platform::SocketCan can;
-    const bool success = can.open("vcan0");
+    SocketCanTransport transport{Device::node()};
+    const bool success = transport.open("vcan0");
     if (!success) {
         MODM_LOG_ERROR << "Opening device vcan0 failed" << modm::endl;
+        return 1;
     }
 
-    auto sendMessage = [&can](const modm::can::Message& message) {
-        can.sendMessage(message);
-    };
-
     /*
     // manually setup default TPDO1 mapping
     // TODO: proper public APi
     Device::transmitPdos_[0].setInactive();
     Device::transmitPdos_[0].setMapping(0, PdoMapping{Address{0x2002, 0}, 32});
     Device::transmitPdos_[0].setMappingCount(1);
-    Device::transmitPdos_[0].setActive();
+    Device::transmitPdos_[0].setActive(Device::accessHandlers, &Device::node());
     Device::transmitPdos_[0].setEventTimeout(500);
     */
 
@@ -63,13 +60,9 @@ int main()
     // to trigger asynchronous PDO transmissions
     Device::setValueChanged(Address{0x2002, 0});
 
-    while (true) {
-        if (can.isMessageAvailable()) {
-            modm::can::Message message{};
-            can.getMessage(message);
-            Device::processMessage(message, sendMessage);
-        }
-        Device::update(sendMessage);
-        std::this_thread::sleep_for(std::chrono::milliseconds{1});
+    // received frames and due PDOs are processed in batches, the thread sleeps in between
+    while (transport.poll()) {
     }
+    MODM_LOG_ERROR << "CAN socket error" << modm::endl;
+    return 1;
 }
@@ -1,68 +1,126 @@
 #ifndef CANOPEN_CANOPEN_DEVICE_HPP
 #define CANOPEN_CANOPEN_DEVICE_HPP
 
-#include <array>
-#include <span>
-#include "object_dictionary.hpp"
-#include "handler_map.hpp"
-#include "receive_pdo.hpp"
-#include "receive_pdo_configurator.hpp"
-#include "transmit_pdo_configurator.hpp"
-#include "transmit_pdo.hpp"
-#include "sdo_server.hpp"
+#include <utility>
+#include "canopen_node.hpp"
 
 
 namespace modm_canopen
 {
 
+/// Single CANopen node with static interface
+/// Use CanopenNode directly to run multiple nodes in one process.
 template<typename OD, typename... Protocols>
 class CanopenDevice
 {
 public:
+    using Node = CanopenNode<OD, Protocols...>;
     using ObjectDictionary = OD;
 
-    static void initialize(uint8_t nodeId) { setNodeId(nodeId); }
+    static constexpr std::size_t ReceivePdoCount = Node::ReceivePdoCount;
+    static constexpr std::size_t TransmitPdoCount = Node::TransmitPdoCount;
 
-    static void setNodeId(uint8_t id);
-    static uint8_t nodeId();
+    static void initialize(uint8_t nodeId) { node_.initialize(nodeId); }
 
-    static void setValueChanged(Address address);
+    static void setNodeId(uint8_t id) { node_.setNodeId(id); }
+    static uint8_t nodeId() { return node_.nodeId(); }
+
+    static void setValueChanged(Address address) { node_.setValueChanged(address); }
+
+    static auto readInto(Address address, std::span<uint8_t> data) -> SdoErrorCode
+    {
+        return node_.readInto(address, data);
+    }
+
+    static auto writeFrom(Address address, std::span<const uint8_t> data) -> SdoErrorCode
+    {
+        return node_.writeFrom(address, data);
+    }
 
     /// call on message reception
     template<typename MessageCallback>
-    static void processMessage(const modm::can::Message& message, MessageCallback&& cb);
+    static void processMessage(const modm::can::Message& message, MessageCallback&& cb)
+    {
+        node_.processMessage(message, std::forward<MessageCallback>(cb));
+    }
 
+    /// call on message reception with the reception time, e.g. a driver timestamp
+    template<typename MessageCallback>
+    static void processMessage(const modm::can::Message& message, modm::PreciseTimestamp timestamp,
+                               MessageCallback&& cb)
+    {
+        node_.processMessage(message, timestamp, std::forward<MessageCallback>(cb));
+    }
+
+    static void setReceivePdoFrameHandler(std::size_t pdo, typename ReceivePdo<OD>::FrameHandler handler)
+    {
+        node_.setReceivePdoFrameHandler(pdo, handler);
+    }
+
+    /// Transmit due PDOs
+    /// \return time until the next call is required, PreciseDuration::max() if nothing is scheduled
     template<typename MessageCallback>
-    static void update(MessageCallback&& cb);
+    static auto update(MessageCallback&& cb) -> modm::PreciseDuration
+    {
+        return node_.update(std::forward<MessageCallback>(cb));
+    }
 
-private:
-    friend ReceivePdoConfigurator<CanopenDevice>;
-    friend TransmitPdoConfigurator<CanopenDevice>;
-    friend SdoServer<CanopenDevice>;
+    /// Transmit due event-driven PDOs only, see CanopenNode::updateTransmitPdos()
+    template<typename MessageCallback>
+    static auto updateTransmitPdos(MessageCallback&& cb) -> modm::PreciseDuration
+    {
+        return node_.updateTransmitPdos(std::forward<MessageCallback>(cb));
+    }
+
+    template<typename Function>
+    static void forEachConsumedCanId(Function&& function)
+    {
+        node_.forEachConsumedCanId(std::forward<Function>(function));
+    }
 
-    using Map = HandlerMap<OD>;
+    static uint32_t consumedCanIdRevision() { return node_.consumedCanIdRevision(); }
 
-    // TODO: replace return value with std::expected like type, add error code to read handler
-    static auto read(Address address) -> std::variant<Value, SdoErrorCode>;
-    static auto write(Address address, Value value) -> SdoErrorCode;
-    static auto write(Address address, std::span<const uint8_t> data, int8_t size = -1) -> SdoErrorCode;
+    template<std::size_t pdo, PdoMapping... mappings>
+    static SdoErrorCode setStaticTransmitPdoMapping()
+    {
+        return node_.template setStaticTransmitPdoMapping<pdo, mappings...>();
+    }
 
-    static constexpr auto registerHandlers() -> HandlerMap<OD>;
-    static constexpr auto constructHandlerMap() -> HandlerMap<OD>;
+    template<std::size_t pdo, PdoMapping... mappings>
+    static SdoErrorCode setStaticReceivePdoMapping()
+    {
+        return node_.template setStaticReceivePdoMapping<pdo, mappings...>();
+    }
 
-    static constexpr HandlerMap<OD> accessHandlers = constructHandlerMap();
+    static SdoErrorCode setTransmitPdoChangeOfValue(std::size_t pdo, bool enabled)
+    {
+        return node_.setTransmitPdoChangeOfValue(pdo, enabled);
+    }
 
-    static inline constinit SdoServer<CanopenDevice> sdoServer_;
-    static inline uint8_t nodeId_{};
+    static SdoErrorCode setTransmitPdoDeadband(std::size_t pdo, uint_fast8_t index, uint32_t deadband)
+    {
+        return node_.setTransmitPdoDeadband(pdo, index, deadband);
+    }
+
+    static void setTransmitBudget(const TransmitBudget& budget) { node_.setTransmitBudget(budget); }
+    static TransmitStatistics transmitStatistics() { return node_.transmitStatistics(); }
+
+    static void setProcessImage(const ProcessImageBase* image) { node_.setProcessImage(image); }
+
+    static typename Node::Storage& storage() { return node_.storage(); }
+
+    static Node& node() { return node_; }
+
+private:
+    static inline constinit Node node_{};
 
 public: // TODO: make private, add public API to configure default PDO mappings
-    static inline constinit std::array<ReceivePdo<OD>, 4> receivePdos_;
-    static inline constinit std::array<TransmitPdo<OD>, 4> transmitPdos_;
+    static constexpr const HandlerMap<OD>& accessHandlers = Node::accessHandlers;
 
+    static inline auto& receivePdos_ = node_.receivePdos_;
+    static inline auto& transmitPdos_ = node_.transmitPdos_;
 };
 
 }
 
-#include "canopen_device_impl.hpp"
-
-#endif // CANOPEN_CANOPEN_DEVICE
+#endif // CANOPEN_CANOPEN_DEVICE_HPP
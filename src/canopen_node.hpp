@@ -0,0 +1,231 @@
+#ifndef CANOPEN_CANOPEN_NODE_HPP
+#define CANOPEN_CANOPEN_NODE_HPP
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <optional>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include "object_dictionary.hpp"
+#include "dispatch_table.hpp"
+#include "handler_map.hpp"
+#include "receive_pdo.hpp"
+#include "receive_pdo_configurator.hpp"
+#include "transmit_pdo_configurator.hpp"
+#include "transmit_pdo.hpp"
+#include "sync_configurator.hpp"
+#include "sdo_server.hpp"
+#include "static_pdo_mapping.hpp"
+#include "process_image.hpp"
+#include "transmit_budget.hpp"
+
+
+namespace modm_canopen
+{
+namespace detail
+{
+
+/// Generated object storage of the dictionary, empty without the object_storage option
+template<typename OD>
+struct ObjectStorage
+{
+    struct type {};
+};
+
+template<typename OD>
+    requires requires { typename OD::Storage; }
+struct ObjectStorage<OD>
+{
+    using type = typename OD::Storage;
+};
+
+}
+
+/// CANopen device instance
+/// All nodes of the same type share the object dictionary and the handler map. Handlers
+/// registered with a context parameter are called with a pointer to the node instance.
+/// The node must not be moved after initialization.
+///
+/// Threading: setValueChanged() can be called from any thread or interrupt. processMessage()
+/// and update() can run on a single thread, or split on a receive thread calling
+/// processMessage() and sdoServer().update() and a transmit thread calling
+/// updateTransmitPdos(). Both threads may call the message callback. Initialization and
+/// static PDO mappings must be set up before the threads are started.
+template<typename OD, typename... Protocols>
+class CanopenNode
+{
+public:
+    using ObjectDictionary = OD;
+    using Storage = typename detail::ObjectStorage<OD>::type;
+
+    static constexpr std::size_t ReceivePdoCount = receivePdoCount<OD>();
+    static constexpr std::size_t TransmitPdoCount = transmitPdoCount<OD>();
+    static_assert(ReceivePdoCount <= MaxPdoCount, "Too many receive PDOs");
+    static_assert(TransmitPdoCount <= MaxPdoCount, "Too many transmit PDOs");
+
+    constexpr CanopenNode() = default;
+    CanopenNode(const CanopenNode&) = delete;
+    CanopenNode& operator=(const CanopenNode&) = delete;
+
+    void initialize(uint8_t nodeId) { setNodeId(nodeId); }
+
+    void setNodeId(uint8_t id);
+    uint8_t nodeId() const;
+
+    /// Mark a TPDO mappable object as changed, lock-free
+    void setValueChanged(Address address);
+
+    /// Read object to data in CANopen (little endian) byte order without constructing a Value
+    /// data must be at least as large as the object.
+    auto readInto(Address address, std::span<uint8_t> data) -> SdoErrorCode;
+
+    /// Write object from data in CANopen (little endian) byte order without constructing a Value
+    /// \param size expected object size in bytes, -1 to accept data of at least the object size
+    auto writeFrom(Address address, std::span<const uint8_t> data, int8_t size = -1) -> SdoErrorCode;
+
+    /// call on message reception
+    template<typename MessageCallback>
+    void processMessage(const modm::can::Message& message, MessageCallback&& cb);
+
+    /// call on message reception with the reception time, e.g. a driver timestamp
+    template<typename MessageCallback>
+    void processMessage(const modm::can::Message& message, modm::PreciseTimestamp timestamp,
+                        MessageCallback&& cb);
+
+    /// Pass received frames of an RPDO to handler instead of the write handlers, nullptr to disable
+    /// See ReceivePdo::setFrameHandler(), the handler is called with a pointer to the node.
+    void setReceivePdoFrameHandler(std::size_t pdo, typename ReceivePdo<OD>::FrameHandler handler);
+
+    /// Transmit due PDOs and handle SDO timeouts
+    /// \return time until the next call is required, PreciseDuration::max() if nothing is scheduled
+    template<typename MessageCallback>
+    auto update(MessageCallback&& cb) -> modm::PreciseDuration;
+
+    /// Transmit due event-driven PDOs, the transmit part of update()
+    /// TPDOs currently reconfigured by processMessage() on another thread are skipped.
+    /// With a transmit budget, see setTransmitBudget(), PDOs are transmitted by priority.
+    /// \return time until the next call is required, PreciseDuration::max() if nothing is scheduled
+    template<typename MessageCallback>
+    auto updateTransmitPdos(MessageCallback&& cb) -> modm::PreciseDuration;
+
+    SdoServer<CanopenNode>& sdoServer() { return sdoServer_; }
+
+    /// Values of the objects bound to the generated storage of this node
+    /// Objects with registered handlers are not bound. Accesses are not synchronized
+    /// with processMessage() and update().
+    Storage& storage() { return storage_; }
+    const Storage& storage() const { return storage_; }
+
+    /// Fix the mapping of an inactive PDO at compile time, see StaticPdoMapping
+    /// Mapped objects are packed without interpreting the mapping at runtime. The
+    /// mapping can't be changed through SDO, the PDO is still (de-)activated by its COB-ID.
+    template<std::size_t pdo, PdoMapping... mappings>
+    SdoErrorCode setStaticTransmitPdoMapping();
+
+    template<std::size_t pdo, PdoMapping... mappings>
+    SdoErrorCode setStaticReceivePdoMapping();
+
+    /// Skip event-driven transmissions of a TPDO if no mapped object changed
+    /// See TransmitPdo::setChangeOfValue(), fails with LocalControl while the TPDO is transmitted.
+    SdoErrorCode setTransmitPdoChangeOfValue(std::size_t pdo, bool enabled);
+
+    /// Set the change of value deadband of a mapped object, see TransmitPdo::setDeadband()
+    SdoErrorCode setTransmitPdoDeadband(std::size_t pdo, uint_fast8_t index, uint32_t deadband);
+
+    /// Pack all TPDOs from consistent snapshots of image, nullptr to disable
+    /// A TPDO packed while a new image is published is packed again, so all mapped objects
+    /// of image belong to the same publication. Read handlers of TPDOs can be called
+    /// more than once per message.
+    void setProcessImage(const ProcessImageBase* image);
+
+    /// Limit the bus load caused by transmit PDOs, TransmitBudget{} to disable the limit
+    /// Due event-driven PDOs are transmitted in order of their COB-IDs while tokens are
+    /// available, the remaining PDOs are deferred and packed again when tokens are refilled.
+    /// Synchronous PDOs are never deferred, their frames are charged to the budget.
+    /// Must not be called concurrently with processMessage() or update().
+    void setTransmitBudget(const TransmitBudget& budget);
+
+    /// Deferred and dropped PDO counters, can be read from any thread
+    TransmitStatistics transmitStatistics() const;
+
+    /// Upper bound of the number of CAN identifiers passed to forEachConsumedCanId()
+    static constexpr std::size_t MaxConsumedCanIdCount = ReceivePdoCount + 2;
+
+    /// Call function(uint32_t canId) for every 11-bit CAN identifier processMessage() consumes
+    /// Identifiers can be reported more than once.
+    template<typename Function>
+    void forEachConsumedCanId(Function&& function) const;
+
+    /// Incremented whenever the set of consumed CAN identifiers may have changed
+    uint32_t consumedCanIdRevision() const { return consumedCanIdRevision_; }
+
+private:
+    friend ReceivePdoConfigurator<CanopenNode>;
+    friend TransmitPdoConfigurator<CanopenNode>;
+    friend SyncConfigurator<CanopenNode>;
+    friend SdoServer<CanopenNode>;
+
+    using Map = HandlerMap<OD>;
+
+    /// Reception time is read from the clock if it's required and not given
+    template<typename MessageCallback>
+    void dispatchMessage(const modm::can::Message& message, std::optional<modm::PreciseTimestamp> timestamp,
+                         MessageCallback&& cb);
+
+    /// Transmit due event-driven PDOs in COB-ID order within the transmit budget
+    template<typename MessageCallback>
+    auto transmitPdosByPriority(modm::PreciseTimestamp now, MessageCallback&& cb) -> modm::PreciseDuration;
+    /// Mark due PDOs (COB-ID, index) left waiting for tokens as deferred
+    void deferPdos(std::span<const std::pair<uint32_t, uint16_t>> pdos);
+
+    template<typename MessageCallback>
+    void processSync(const modm::can::Message& message, MessageCallback&& cb);
+
+    void updateDispatchTable();
+    void invalidateTransmitSchedule() { transmitScheduleValid_ = false; }
+
+    static constexpr auto registerHandlers() -> HandlerMap<OD>;
+    static constexpr auto constructHandlerMap() -> HandlerMap<OD>;
+    /// Bind objects of the generated storage without registered handlers to storage_
+    template<std::size_t... Indices>
+    static constexpr void bindStorage(HandlerMap<OD>& handlers, std::index_sequence<Indices...>);
+    template<Address address, auto member>
+    static constexpr void bindStorageObject(HandlerMap<OD>& handlers);
+
+    SdoServer<CanopenNode> sdoServer_{*this};
+    uint8_t nodeId_{};
+    DispatchTable<ReceivePdoCount> dispatchTable_{};
+    uint32_t consumedCanIdRevision_{};
+    uint16_t syncCanId_{0x080};
+    modm::PreciseDuration syncWindow_{};
+    uint8_t syncCounterOverflow_{};
+    ValueChangeCounters<OD> valueChanges_{};
+    /// Earliest TPDO deadline as delay from the last full schedule update
+    /// Invalidated by value changes and TPDO configuration from any thread
+    modm::PreciseTimestamp transmitScheduleTime_{};
+    modm::PreciseDuration transmitScheduleDelay_{};
+    std::atomic<bool> transmitScheduleValid_{false};
+    TransmitBudget transmitBudget_{};
+    /// Tokens of synchronous PDOs, charged to the budget by the next transmit update
+    std::atomic<uint32_t> synchronousTokens_{};
+    /// Due PDOs waiting for tokens, only accessed by the transmit thread
+    std::array<bool, TransmitPdoCount> transmitDeferred_{};
+    std::atomic<uint32_t> deferredCount_{};
+    std::atomic<uint32_t> droppedCount_{};
+    [[no_unique_address]] Storage storage_{};
+
+public: // TODO: make private, add public API to configure default PDO mappings
+    static constexpr HandlerMap<OD> accessHandlers = constructHandlerMap();
+
+    std::array<ReceivePdo<OD>, ReceivePdoCount> receivePdos_{};
+    std::array<TransmitPdo<OD>, TransmitPdoCount> transmitPdos_{};
+
+};
+
+}
+
+#include "canopen_node_impl.hpp"
+
+#endif // CANOPEN_CANOPEN_NODE_HPP
@@ -0,0 +1,484 @@
+#ifndef CANOPEN_CANOPEN_NODE_HPP
+#error "Do not include this file directly, use canopen_node.hpp instead"
+#endif
+
+namespace modm_canopen
+{
+namespace detail
+{
+
+template<Address address>
+struct missing_read_handler {
+    static_assert(address == Address{},
+                  "Read handler not registered for at least one object");
+};
+
+template<Address address>
+struct missing_write_handler {
+    static_assert(address == Address{},
+                  "Write handler not registered for at least one object");
+};
+
+}
+
+template<typename OD, typename... Protocols>
+auto CanopenNode<OD, Protocols...>::writeFrom(Address address,
+                                              std::span<const uint8_t> data,
+                                              int8_t size) -> SdoErrorCode
+{
+    auto entry = OD::map.lookup(address);
+    if (!entry) {
+        return SdoErrorCode::ObjectDoesNotExist;
+    }
+    if (!entry->isWritable()) {
+        return SdoErrorCode::WriteOfReadOnlyObject;
+    }
+
+    const auto objectSize = getDataTypeSize(entry->dataType);
+    const bool sizeIsValid = (objectSize > 0) && (objectSize <= data.size()) &&
+        ((size == -1) || (size == int8_t(objectSize)));
+    if (!sizeIsValid) {
+        return SdoErrorCode::UnsupportedAccess;
+    }
+
+    auto handler = accessHandlers.lookupWriteHandler(address);
+    if (handler) {
+        const auto result = callWriteHandler(*handler, this, data.data());
+        if (result == SdoErrorCode::NoError) {
+            setValueChanged(address);
+        }
+
+        return result;
+    }
+    return SdoErrorCode::UnsupportedAccess;
+}
+
+template<typename OD, typename... Protocols>
+template<std::size_t pdo, PdoMapping... mappings>
+SdoErrorCode CanopenNode<OD, Protocols...>::setStaticTransmitPdoMapping()
+{
+    static_assert(pdo < TransmitPdoCount, "Transmit PDO does not exist");
+    using Mapping = StaticPdoMapping<OD, accessHandlers, mappings...>;
+    return transmitPdos_[pdo].setStaticMapping(Mapping::Mappings, &Mapping::pack);
+}
+
+template<typename OD, typename... Protocols>
+template<std::size_t pdo, PdoMapping... mappings>
+SdoErrorCode CanopenNode<OD, Protocols...>::setStaticReceivePdoMapping()
+{
+    static_assert(pdo < ReceivePdoCount, "Receive PDO does not exist");
+    using Mapping = StaticPdoMapping<OD, accessHandlers, mappings...>;
+    return receivePdos_[pdo].setStaticMapping(Mapping::Mappings, &Mapping::unpack);
+}
+
+template<typename OD, typename... Protocols>
+SdoErrorCode CanopenNode<OD, Protocols...>::setTransmitPdoChangeOfValue(std::size_t pdo, bool enabled)
+{
+    auto& tpdo = transmitPdos_[pdo];
+    if (!tpdo.tryClaim()) {
+        return SdoErrorCode::LocalControl;
+    }
+    tpdo.setChangeOfValue(enabled);
+    tpdo.release();
+    invalidateTransmitSchedule();
+    return SdoErrorCode::NoError;
+}
+
+template<typename OD, typename... Protocols>
+SdoErrorCode CanopenNode<OD, Protocols...>::setTransmitPdoDeadband(std::size_t pdo, uint_fast8_t index,
+                                                                  uint32_t deadband)
+{
+    auto& tpdo = transmitPdos_[pdo];
+    if (!tpdo.tryClaim()) {
+        return SdoErrorCode::LocalControl;
+    }
+    const auto result = tpdo.setDeadband(index, deadband);
+    tpdo.release();
+    return result;
+}
+
+template<typename OD, typename... Protocols>
+void CanopenNode<OD, Protocols...>::setProcessImage(const ProcessImageBase* image)
+{
+    for (auto& tpdo : transmitPdos_) {
+        tpdo.setProcessImage(image);
+    }
+}
+
+template<typename OD, typename... Protocols>
+auto CanopenNode<OD, Protocols...>::readInto(Address address, std::span<uint8_t> data) -> SdoErrorCode
+{
+    auto entry = OD::map.lookup(address);
+    if (!entry) {
+        return SdoErrorCode::ObjectDoesNotExist;
+    }
+    if (!entry->isReadable()) {
+        return SdoErrorCode::ReadOfWriteOnlyObject;
+    }
+
+    // domains are read in chunks through the domain read handler
+    const auto objectSize = getDataTypeSize(entry->dataType);
+    if (objectSize == 0 || objectSize > data.size()) {
+        return SdoErrorCode::UnsupportedAccess;
+    }
+
+    auto handler = accessHandlers.lookupReadHandler(address);
+    if (handler && callReadHandler(*handler, this, data.data()) == objectSize) {
+        return SdoErrorCode::NoError;
+    }
+    return SdoErrorCode::UnsupportedAccess;
+}
+
+template<typename OD, typename... Protocols>
+template<typename MessageCallback>
+void CanopenNode<OD, Protocols...>::processMessage(const modm::can::Message& message, MessageCallback&& cb)
+{
+    dispatchMessage(message, std::nullopt, std::forward<MessageCallback>(cb));
+}
+
+template<typename OD, typename... Protocols>
+template<typename MessageCallback>
+void CanopenNode<OD, Protocols...>::processMessage(const modm::can::Message& message,
+                                                   modm::PreciseTimestamp timestamp, MessageCallback&& cb)
+{
+    dispatchMessage(message, timestamp, std::forward<MessageCallback>(cb));
+}
+
+template<typename OD, typename... Protocols>
+void CanopenNode<OD, Protocols...>::setReceivePdoFrameHandler(std::size_t pdo,
+                                                              typename ReceivePdo<OD>::FrameHandler handler)
+{
+    receivePdos_[pdo].setFrameHandler(handler);
+}
+
+template<typename OD, typename... Protocols>
+template<typename MessageCallback>
+void CanopenNode<OD, Protocols...>::dispatchMessage(const modm::can::Message& message,
+                                                    std::optional<modm::PreciseTimestamp> timestamp,
+                                                    MessageCallback&& cb)
+{
+    if (message.isExtended()) {
+        return;
+    }
+    const auto target = dispatchTable_.lookup(message.identifier);
+    switch (target.consumer) {
+    case MessageConsumer::ReceivePdo: {
+        auto& rpdo = receivePdos_[target.index];
+        if (!timestamp && rpdo.hasFrameHandler()) {
+            timestamp = modm::chrono::micro_clock::now();
+        }
+        rpdo.processMessage(message, timestamp.value_or(modm::PreciseTimestamp{}), [this](Address address) {
+            setValueChanged(address);
+        });
+        break;
+    }
+    case MessageConsumer::Sdo:
+        sdoServer_.processMessage(message, std::forward<MessageCallback>(cb));
+        break;
+    case MessageConsumer::Sync:
+        processSync(message, std::forward<MessageCallback>(cb));
+        break;
+    case MessageConsumer::None:
+        break;
+    }
+}
+
+template<typename OD, typename... Protocols>
+template<typename MessageCallback>
+void CanopenNode<OD, Protocols...>::processSync(const modm::can::Message& message, MessageCallback&& cb)
+{
+    const auto syncTime = modm::chrono::micro_clock::now();
+    const bool counterEnabled = (syncCounterOverflow_ > 1) && (message.getLength() >= 1);
+    const uint8_t counter = counterEnabled ? message.data[0] : 0;
+    const bool windowEnabled = (syncWindow_.count() != 0);
+
+    for (auto& tpdo : transmitPdos_) {
+        const auto pdoMessage = tpdo.sync(counter, valueChanges_);
+        if (pdoMessage) {
+            // synchronous PDOs are discarded after the synchronous window expired
+            const bool windowExpired = windowEnabled &&
+                (modm::chrono::micro_clock::now() - syncTime) > syncWindow_;
+            if (windowExpired) {
+                droppedCount_.fetch_add(1, std::memory_order_relaxed);
+                continue;
+            }
+            if (transmitBudget_.isLimited()) {
+                synchronousTokens_.fetch_add(transmitBudget_.cost(*pdoMessage), std::memory_order_relaxed);
+            }
+            std::forward<MessageCallback>(cb)(*pdoMessage);
+        }
+    }
+
+    for (auto& rpdo : receivePdos_) {
+        rpdo.sync([this](Address address) {
+            setValueChanged(address);
+        });
+    }
+}
+
+template<typename OD, typename... Protocols>
+template<typename MessageCallback>
+auto CanopenNode<OD, Protocols...>::update(MessageCallback&& cb) -> modm::PreciseDuration
+{
+    const auto sdoTimeout = sdoServer_.update(std::forward<MessageCallback>(cb));
+    return std::min(sdoTimeout, updateTransmitPdos(std::forward<MessageCallback>(cb)));
+}
+
+template<typename OD, typename... Protocols>
+template<typename MessageCallback>
+auto CanopenNode<OD, Protocols...>::updateTransmitPdos(MessageCallback&& cb) -> modm::PreciseDuration
+{
+    const auto now = modm::chrono::micro_clock::now();
+    const auto elapsed = now - transmitScheduleTime_;
+    if (transmitScheduleValid_ && elapsed < transmitScheduleDelay_) {
+        if (transmitScheduleDelay_ == modm::PreciseDuration::max()) {
+            return transmitScheduleDelay_;
+        }
+        return transmitScheduleDelay_ - elapsed;
+    }
+
+    // set before polling the change counters, changes during the loop invalidate it again
+    transmitScheduleValid_ = true;
+    auto delay = modm::PreciseDuration::max();
+    if (transmitBudget_.isLimited()) {
+        delay = transmitPdosByPriority(now, std::forward<MessageCallback>(cb));
+    } else {
+        for (auto& tpdo : transmitPdos_) {
+            if (!tpdo.isActive()) {
+                continue;
+            }
+            if (!tpdo.tryClaim()) {
+                // reconfigured by the receive thread, retry immediately
+                transmitScheduleValid_ = false;
+                delay = modm::PreciseDuration{};
+                continue;
+            }
+            if (tpdo.isActive()) {
+                auto message = tpdo.nextMessage(now, valueChanges_);
+                if (message) {
+                    std::forward<MessageCallback>(cb)(*message);
+                }
+                delay = std::min(delay, tpdo.timeUntilNextMessage(now));
+            }
+            tpdo.release();
+        }
+    }
+    transmitScheduleTime_ = now;
+    transmitScheduleDelay_ = delay;
+    return delay;
+}
+
+template<typename OD, typename... Protocols>
+template<typename MessageCallback>
+auto CanopenNode<OD, Protocols...>::transmitPdosByPriority(modm::PreciseTimestamp now, MessageCallback&& cb)
+    -> modm::PreciseDuration
+{
+    transmitBudget_.refill(now);
+    transmitBudget_.consume(synchronousTokens_.exchange(0, std::memory_order_relaxed));
+
+    // the COB-ID is the arbitration priority on the bus, lower identifiers win
+    std::array<std::pair<uint32_t, uint16_t>, TransmitPdoCount> due{};
+    std::size_t dueCount = 0;
+    auto delay = modm::PreciseDuration::max();
+    for (std::size_t i = 0; i < transmitPdos_.size(); ++i) {
+        auto& tpdo = transmitPdos_[i];
+        if (!tpdo.isActive()) {
+            continue;
+        }
+        if (!tpdo.tryClaim()) {
+            transmitScheduleValid_ = false;
+            delay = modm::PreciseDuration{};
+            continue;
+        }
+        if (tpdo.isActive()) {
+            if (tpdo.isDue(now, valueChanges_)) {
+                const std::pair entry{tpdo.canId(), uint16_t(i)};
+                const auto end = due.begin() + dueCount++;
+                const auto position = std::upper_bound(due.begin(), end, entry);
+                std::move_backward(position, end, end + 1);
+                *position = entry;
+            } else {
+                transmitDeferred_[i] = false;
+                delay = std::min(delay, tpdo.timeUntilNextMessage(now));
+            }
+        }
+        tpdo.release();
+    }
+
+    for (std::size_t i = 0; i < dueCount; ++i) {
+        auto& tpdo = transmitPdos_[due[i].second];
+        if (!tpdo.tryClaim()) {
+            transmitScheduleValid_ = false;
+            delay = modm::PreciseDuration{};
+            continue;
+        }
+        if (tpdo.isActive()) {
+            const auto cost = transmitBudget_.cost(tpdo.payloadSize());
+            const auto wait = transmitBudget_.timeUntilAvailable(cost);
+            if (wait.count() != 0) {
+                // lower priority PDOs must not overtake a deferred one
+                tpdo.release();
+                deferPdos(std::span{due}.subspan(i, dueCount - i));
+                return std::min(delay, wait);
+            }
+            transmitDeferred_[due[i].second] = false;
+            auto message = tpdo.nextMessage(now, valueChanges_);
+            if (message) {
+                transmitBudget_.consume(cost);
+                std::forward<MessageCallback>(cb)(*message);
+            }
+            delay = std::min(delay, tpdo.timeUntilNextMessage(now));
+        }
+        tpdo.release();
+    }
+    return delay;
+}
+
+template<typename OD, typename... Protocols>
+void CanopenNode<OD, Protocols...>::deferPdos(std::span<const std::pair<uint32_t, uint16_t>> pdos)
+{
+    // PDOs waiting for tokens over several updates are counted once
+    uint32_t count = 0;
+    for (const auto& [canId, index] : pdos) {
+        count += transmitDeferred_[index] ? 0 : 1;
+        transmitDeferred_[index] = true;
+    }
+    deferredCount_.fetch_add(count, std::memory_order_relaxed);
+}
+
+template<typename OD, typename... Protocols>
+void CanopenNode<OD, Protocols...>::setTransmitBudget(const TransmitBudget& budget)
+{
+    transmitBudget_ = budget;
+    transmitBudget_.reset(modm::chrono::micro_clock::now());
+    synchronousTokens_ = 0;
+    transmitDeferred_.fill(false);
+    invalidateTransmitSchedule();
+}
+
+template<typename OD, typename... Protocols>
+TransmitStatistics CanopenNode<OD, Protocols...>::transmitStatistics() const
+{
+    return TransmitStatistics{
+        .deferred = deferredCount_.load(std::memory_order_relaxed),
+        .dropped = droppedCount_.load(std::memory_order_relaxed)
+    };
+}
+
+template<typename OD, typename... Protocols>
+void CanopenNode<OD, Protocols...>::setValueChanged(Address address)
+{
+    const auto index = ValueChangeCounters<OD>::index(address);
+    if (index != ValueChangeCounters<OD>::NoIndex) {
+        valueChanges_.setChanged(index);
+        invalidateTransmitSchedule();
+    }
+}
+
+template<typename OD, typename... Protocols>
+void CanopenNode<OD, Protocols...>::setNodeId(uint8_t id)
+{
+    nodeId_ = id & 0x7f;
+    // default COB-IDs of the predefined connection set exist for the first four PDOs only
+    for (std::size_t i = 0; i < std::min<std::size_t>(transmitPdos_.size(), 4); ++i) {
+        transmitPdos_[i].setCanId((0x100 * (i + 1) + 0x80) | nodeId_);
+    }
+    for (std::size_t i = 0; i < std::min<std::size_t>(receivePdos_.size(), 4); ++i) {
+        receivePdos_[i].setCanId(0x100 * (i + 2) | nodeId_);
+    }
+    sdoServer_.setNodeId(id);
+    updateDispatchTable();
+}
+
+template<typename OD, typename... Protocols>
+template<typename Function>
+void CanopenNode<OD, Protocols...>::forEachConsumedCanId(Function&& function) const
+{
+    // must match the identifiers set in updateDispatchTable()
+    function(uint32_t{syncCanId_});
+    function(uint32_t{0x600u | nodeId_});
+    for (const auto& rpdo : receivePdos_) {
+        if (rpdo.isActive() && rpdo.canId() < DispatchTable<ReceivePdoCount>::Size) {
+            function(uint32_t{rpdo.canId()});
+        }
+    }
+}
+
+template<typename OD, typename... Protocols>
+void CanopenNode<OD, Protocols...>::updateDispatchTable()
+{
+    ++consumedCanIdRevision_;
+    dispatchTable_.clear();
+    dispatchTable_.set(syncCanId_, MessageConsumer::Sync);
+    dispatchTable_.set(0x600 | nodeId_, MessageConsumer::Sdo);
+    for (std::size_t i = 0; i < receivePdos_.size(); ++i) {
+        if (receivePdos_[i].isActive()) {
+            dispatchTable_.setReceivePdo(receivePdos_[i].canId(), i);
+        }
+    }
+}
+
+template<typename OD, typename... Protocols>
+uint8_t CanopenNode<OD, Protocols...>::nodeId() const
+{
+    return nodeId_;
+}
+
+template<typename OD, typename... Protocols>
+constexpr auto CanopenNode<OD, Protocols...>::registerHandlers() -> HandlerMap<OD>
+{
+    HandlerMap<OD> handlers;
+    ReceivePdoConfigurator<CanopenNode>{}.registerHandlers(handlers);
+    TransmitPdoConfigurator<CanopenNode>{}.registerHandlers(handlers);
+    SyncConfigurator<CanopenNode>{}.registerHandlers(handlers);
+    (Protocols{}.registerHandlers(handlers), ...);
+    if constexpr (requires { OD::storageBindings; }) {
+        bindStorage(handlers, std::make_index_sequence<OD::storageBindings.size()>{});
+    }
+
+    return handlers;
+}
+
+template<typename OD, typename... Protocols>
+template<std::size_t... Indices>
+constexpr void CanopenNode<OD, Protocols...>::bindStorage(HandlerMap<OD>& handlers,
+                                                        std::index_sequence<Indices...>)
+{
+    (bindStorageObject<OD::storageBindings[Indices].address,
+                       std::get<OD::storageBindings[Indices].member.index()>(
+                           OD::storageBindings[Indices].member)>(handlers), ...);
+}
+
+template<typename OD, typename... Protocols>
+template<Address address, auto member>
+constexpr void CanopenNode<OD, Protocols...>::bindStorageObject(HandlerMap<OD>& handlers)
+{
+    using T = std::remove_cvref_t<decltype(std::declval<Storage&>().*member)>;
+    constexpr auto entry = OD::map.lookup(address);
+
+    // objects with a handler in either direction are handled by the application
+    if (handlers.hasHandler(address)) {
+        return;
+    }
+    if constexpr (entry->isReadable()) {
+        handlers.template setReadHandler<address>(+[](void* context) -> T {
+            return static_cast<CanopenNode*>(context)->storage_.*member;
+        });
+    }
+    if constexpr (entry->isWritable()) {
+        handlers.template setWriteHandler<address>(+[](void* context, T value) -> SdoErrorCode {
+            static_cast<CanopenNode*>(context)->storage_.*member = value;
+            return SdoErrorCode::NoError;
+        });
+    }
+}
+
+template<typename OD, typename... Protocols>
+constexpr auto CanopenNode<OD, Protocols...>::constructHandlerMap() -> HandlerMap<OD>
+{
+    constexpr HandlerMap<OD> handlers = registerHandlers();
+    detail::missing_read_handler<findMissingReadHandler(handlers)>();
+    detail::missing_write_handler<findMissingWriteHandler(handlers)>();
+    return handlers;
+}
+}
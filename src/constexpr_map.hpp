@@ -3,12 +3,24 @@
 
 #include <algorithm>
 #include <array>
+#include <bit>
+#include <concepts>
+#include <cstdint>
 #include <iterator>
+#include <limits>
+#include <type_traits>
 #include <utility>
 
 namespace modm_canopen
 {
 
+/// Keys providing a constexprMapHash() overload found by ADL are looked up
+/// through a hash index, all other keys by binary search.
+template<typename K>
+concept ConstexprMapHashable = requires(const K& key) {
+    { constexprMapHash(key) } -> std::convertible_to<uint32_t>;
+};
+
 template<typename K, typename V,
     std::size_t C, typename Cmp = std::less<>>
 class ConstexprMap
@@ -20,8 +32,52 @@ public:
     using Element = std::pair<Key, Value>;
 
     static constexpr auto Capacity = C;
+    static constexpr bool HasHashIndex = ConstexprMapHashable<Key>;
+
+    /// Iterator over elements in key order, dereferences to a pair of references
+    template<bool IsConst>
+    class ElementIterator
+    {
+        using MapPointer = std::conditional_t<IsConst, const ConstexprMap*, ConstexprMap*>;
+        using ValueReference = std::conditional_t<IsConst, const Value&, Value&>;
 
-    using const_iterator = std::array<Element, Capacity>::const_iterator;
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using difference_type = std::ptrdiff_t;
+        using value_type = Element;
+        using reference = std::pair<const Key&, ValueReference>;
+        using pointer = void;
+
+        constexpr ElementIterator() = default;
+        constexpr ElementIterator(MapPointer map, std::size_t position) : map_{map}, position_{position} {}
+
+        constexpr reference operator*() const noexcept
+        {
+            return reference{map_->keys_[position_], map_->values_[position_]};
+        }
+
+        constexpr ElementIterator& operator++() noexcept
+        {
+            ++position_;
+            return *this;
+        }
+
+        constexpr ElementIterator operator++(int) noexcept
+        {
+            auto it = *this;
+            ++position_;
+            return it;
+        }
+
+        constexpr bool operator==(const ElementIterator&) const noexcept = default;
+
+    private:
+        MapPointer map_ = nullptr;
+        std::size_t position_ = 0;
+    };
+
+    using iterator = ElementIterator<false>;
+    using const_iterator = ElementIterator<true>;
 
     class OptionalValueRef
     {
@@ -81,14 +137,16 @@ public:
         const Value* data_ = nullptr;
     };
 
-    constexpr ConstexprMap() {}
+    constexpr ConstexprMap() { buildIndex(); }
 
     template<std::forward_iterator Iterator>
     constexpr ConstexprMap(Iterator begin, Iterator end) noexcept
     {
         std::size_t inSize = std::distance(begin, end);
         size_ = std::min(inSize, Capacity);
-        std::move(begin, begin + size_, std::begin(data_));
+
+        std::array<Element, Capacity> elements{};
+        std::move(begin, begin + size_, std::begin(elements));
 
         auto compare = [cmp = Compare{}](const auto& elem0, const auto& elem1) {
             const auto& key0 = elem0.first;
@@ -98,24 +156,55 @@ public:
 
         // use partial_sort because of gcc bug:
         // std::sort is not always constexpr
-        std::partial_sort(std::begin(data_),
-                          std::begin(data_) + size_,
-                          std::begin(data_) + size_,
+        std::partial_sort(std::begin(elements),
+                          std::begin(elements) + size_,
+                          std::begin(elements) + size_,
                           compare);
+
+        for (std::size_t i = 0; i < size_; ++i) {
+            keys_[i] = elements[i].first;
+            values_[i] = std::move(elements[i].second);
+        }
+        buildIndex();
     }
 
-    constexpr ConstOptionalValueRef lookup(Key key) const noexcept
+    /// Construct map from keys already sorted by Compare, all elements are set to value
+    /// Avoids sorting during constant evaluation, keys must be unique.
+    template<std::size_t N>
+    static constexpr ConstexprMap fromSortedKeys(const std::array<Key, N>& keys, const Value& value = Value{}) noexcept
     {
-        auto keyCompare = Compare{};
-        auto elemCompare = [&keyCompare](const auto& elem0, const auto& elem1) {
-            const auto& key0 = elem0.first;
-            const auto& key1 = elem1;//.first;
-            return keyCompare(key0, key1);
-        };
+        static_assert(N <= Capacity, "Too many keys for map capacity");
+        ConstexprMap map{};
+        map.size_ = N;
+        for (std::size_t i = 0; i < N; ++i) {
+            map.keys_[i] = keys[i];
+            map.values_[i] = value;
+        }
+        map.buildIndex();
+        return map;
+    }
 
-        const auto result = std::lower_bound(data_.begin(), data_.begin() + size_, key, elemCompare);
-        if (result != data_.end() && !(keyCompare(key, result->first))) {
-            return ConstOptionalValueRef(result->second);
+    /// Construct map from values already sorted by the key returned by key(value)
+    /// Avoids sorting during constant evaluation, keys must be unique.
+    template<std::size_t N, typename KeyFunction>
+    static constexpr ConstexprMap fromSortedValues(const std::array<Value, N>& values, KeyFunction key) noexcept
+    {
+        static_assert(N <= Capacity, "Too many values for map capacity");
+        ConstexprMap map{};
+        map.size_ = N;
+        for (std::size_t i = 0; i < N; ++i) {
+            map.keys_[i] = key(values[i]);
+            map.values_[i] = values[i];
+        }
+        map.buildIndex();
+        return map;
+    }
+
+    constexpr ConstOptionalValueRef lookup(Key key) const noexcept
+    {
+        const std::size_t position = find(key);
+        if (position < size_) {
+            return ConstOptionalValueRef(values_[position]);
         } else {
             return {};
         }
@@ -123,16 +212,9 @@ public:
 
     constexpr OptionalValueRef lookup(Key key) noexcept
     {
-        auto keyCompare = Compare{};
-        auto elemCompare = [&keyCompare](const auto& elem0, const auto& elem1) {
-            const auto& key0 = elem0.first;
-            const auto& key1 = elem1;//.first;
-            return keyCompare(key0, key1);
-        };
-
-        const auto result = std::lower_bound(data_.begin(), data_.begin() + size_, key, elemCompare);
-        if (result != data_.end() && !(keyCompare(key, result->first))) {
-            return OptionalValueRef(result->second);
+        const std::size_t position = find(key);
+        if (position < size_) {
+            return OptionalValueRef(values_[position]);
         } else {
             return {};
         }
@@ -140,11 +222,72 @@ public:
 
     constexpr std::size_t size() const noexcept { return size_; }
 
-    constexpr const_iterator begin() const noexcept { return data_.cbegin(); }
-    constexpr const_iterator end() const noexcept { return data_.cend(); }
+    constexpr const_iterator begin() const noexcept { return const_iterator{this, 0}; }
+    constexpr const_iterator end() const noexcept { return const_iterator{this, size_}; }
+
+    constexpr iterator begin() noexcept { return iterator{this, 0}; }
+    constexpr iterator end() noexcept { return iterator{this, size_}; }
 
 private:
-    std::array<Element, Capacity> data_;
+    // open addressing hash table with linear probing, filled to at most 50%
+    static constexpr std::size_t IndexBits = std::bit_width(std::max<std::size_t>(2 * Capacity, 2) - 1);
+    static constexpr std::size_t IndexSize = HasHashIndex ? (std::size_t(1) << IndexBits) : 0;
+    static constexpr std::size_t IndexMask = (std::size_t(1) << IndexBits) - 1;
+    static_assert(IndexBits < 32, "Map capacity too large for hash index");
+
+    using Position = std::conditional_t<(Capacity < 0xFFFF), uint16_t, uint32_t>;
+    static constexpr Position EmptySlot = std::numeric_limits<Position>::max();
+
+    static constexpr bool equivalent(const Key& key0, const Key& key1) noexcept
+    {
+        auto keyCompare = Compare{};
+        return !keyCompare(key0, key1) && !keyCompare(key1, key0);
+    }
+
+    static constexpr std::size_t slot(const Key& key) noexcept
+    {
+        // Fibonacci hashing, the upper bits of the product are best distributed
+        const uint32_t hash = static_cast<uint32_t>(constexprMapHash(key)) * 0x9E37'79B1u;
+        return hash >> (32 - IndexBits);
+    }
+
+    constexpr void buildIndex() noexcept
+    {
+        if constexpr (HasHashIndex) {
+            index_.fill(EmptySlot);
+            for (std::size_t position = 0; position < size_; ++position) {
+                std::size_t s = slot(keys_[position]);
+                while (index_[s] != EmptySlot) {
+                    s = (s + 1) & IndexMask;
+                }
+                index_[s] = static_cast<Position>(position);
+            }
+        }
+    }
+
+    /// \return position of key or size() if not found
+    constexpr std::size_t find(const Key& key) const noexcept
+    {
+        if constexpr (HasHashIndex) {
+            for (std::size_t s = slot(key); index_[s] != EmptySlot; s = (s + 1) & IndexMask) {
+                if (equivalent(keys_[index_[s]], key)) {
+                    return index_[s];
+                }
+            }
+            return size_;
+        } else {
+            const auto result = std::lower_bound(keys_.begin(), keys_.begin() + size_, key, Compare{});
+            if (result != keys_.begin() + size_ && equivalent(*result, key)) {
+                return std::distance(keys_.begin(), result);
+            }
+            return size_;
+        }
+    }
+
+    // keys and values are stored separately to keep lookups within the key array
+    std::array<Key, Capacity> keys_{};
+    std::array<Value, Capacity> values_{};
+    std::array<Position, IndexSize> index_{};
     std::size_t size_ = 0;
 };
 
@@ -0,0 +1,76 @@
+#ifndef CANOPEN_DISPATCH_TABLE_HPP
+#define CANOPEN_DISPATCH_TABLE_HPP
+
+#include <array>
+#include <cstdint>
+#include <type_traits>
+
+namespace modm_canopen
+{
+
+enum class MessageConsumer : uint8_t
+{
+    None,
+    Sync,
+    Sdo,
+    ReceivePdo
+};
+
+struct DispatchTarget
+{
+    MessageConsumer consumer;
+    uint_fast16_t index; // receive PDO index, only valid for MessageConsumer::ReceivePdo
+};
+
+/// Maps 11-bit CAN identifiers to the protocol consuming them with a single table lookup
+/// The table has to be rebuilt by the device when the node id or a COB-ID changes.
+/// Entries are 8 bit wide for up to 252 receive PDOs and 16 bit wide otherwise.
+template<std::size_t ReceivePdoCount>
+class DispatchTable
+{
+    static constexpr std::size_t FirstReceivePdo = static_cast<std::size_t>(MessageConsumer::ReceivePdo);
+    using TableEntry = std::conditional_t<(ReceivePdoCount <= (0x100 - FirstReceivePdo)), uint8_t, uint16_t>;
+    static_assert(ReceivePdoCount <= (0x10000 - FirstReceivePdo), "Too many receive PDOs for dispatch table");
+
+public:
+    static constexpr std::size_t Size{0x800};
+
+    constexpr void clear()
+    {
+        table_.fill(0);
+    }
+
+    constexpr void set(uint32_t canId, MessageConsumer consumer)
+    {
+        if (canId < Size) {
+            table_[canId] = static_cast<TableEntry>(consumer);
+        }
+    }
+
+    constexpr void setReceivePdo(uint32_t canId, uint_fast16_t index)
+    {
+        if (canId < Size && index < ReceivePdoCount) {
+            table_[canId] = static_cast<TableEntry>(FirstReceivePdo + index);
+        }
+    }
+
+    constexpr DispatchTarget lookup(uint32_t canId) const
+    {
+        if (canId >= Size) {
+            return DispatchTarget{MessageConsumer::None, 0};
+        }
+        const TableEntry entry = table_[canId];
+        if (entry < FirstReceivePdo) {
+            return DispatchTarget{static_cast<MessageConsumer>(entry), 0};
+        }
+        return DispatchTarget{MessageConsumer::ReceivePdo, uint_fast16_t(entry - FirstReceivePdo)};
+    }
+
+private:
+    // zero-initialized table drops all messages
+    std::array<TableEntry, Size> table_{};
+};
+
+}
+
+#endif // CANOPEN_DISPATCH_TABLE_HPP
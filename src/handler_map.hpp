@@ -2,7 +2,10 @@
 #define CANOPEN_HANDLER_MAP_HPP
 
 #include <cstdint>
+#include <cstring>
+#include <span>
 #include <variant>
+#include "object_dictionary.hpp"
 #include "sdo_error.hpp"
 #include "constexpr_map.hpp"
 
@@ -15,29 +18,82 @@ using ReadFunction = T(*)();
 template<typename T>
 using WriteFunction = SdoErrorCode(*)(T);
 
+/// Copy up to data.size() bytes of a domain object starting at offset to data
+/// \return number of bytes copied, less than data.size() if the end of the object is reached
+using DomainReadFunction = std::size_t(*)(std::size_t offset, std::span<uint8_t> data);
+
+/// Write chunk of a domain object received at offset
+/// complete is set for the last chunk of the transfer. Chunks are never empty unless
+/// complete is set. An aborted or timed out transfer is signalled by an empty chunk
+/// without complete flag, previously received chunks must then be discarded.
+using DomainWriteFunction = SdoErrorCode(*)(std::size_t offset, std::span<const uint8_t> data, bool complete);
+
+// Handlers receiving the context pointer of the device instance, see CanopenNode
+template<typename T>
+using ContextReadFunction = T(*)(void* context);
+
+template<typename T>
+using ContextWriteFunction = SdoErrorCode(*)(void* context, T);
+
+using ContextDomainReadFunction = std::size_t(*)(void* context, std::size_t offset, std::span<uint8_t> data);
+
+using ContextDomainWriteFunction = SdoErrorCode(*)(void* context, std::size_t offset,
+                                                   std::span<const uint8_t> data, bool complete);
+
+/// Registered handler function, either with or without context parameter
+template<typename Function, typename ContextFunction>
+struct HandlerFunction
+{
+    Function function{};
+    ContextFunction contextFunction{};
+
+    constexpr explicit operator bool() const { return function || contextFunction; }
+
+    template<typename... Args>
+    constexpr auto operator()(void* context, Args... args) const
+    {
+        if (function) {
+            return function(args...);
+        }
+        return contextFunction(context, args...);
+    }
+};
+
+template<typename T>
+using ReadHandlerFunction = HandlerFunction<ReadFunction<T>, ContextReadFunction<T>>;
+
+template<typename T>
+using WriteHandlerFunction = HandlerFunction<WriteFunction<T>, ContextWriteFunction<T>>;
+
+using DomainReadHandler = HandlerFunction<DomainReadFunction, ContextDomainReadFunction>;
+
+using DomainWriteHandler = HandlerFunction<DomainWriteFunction, ContextDomainWriteFunction>;
+
 using ReadHandler = std::variant<
     std::monostate,
-    ReadFunction<uint8_t>,
-    ReadFunction<uint16_t>,
-    ReadFunction<uint32_t>,
-    ReadFunction<uint64_t>,
-    ReadFunction<int8_t>,
-    ReadFunction<int16_t>,
-    ReadFunction<int32_t>,
-    ReadFunction<int64_t>
+    ReadHandlerFunction<uint8_t>,
+    ReadHandlerFunction<uint16_t>,
+    ReadHandlerFunction<uint32_t>,
+    ReadHandlerFunction<uint64_t>,
+    ReadHandlerFunction<int8_t>,
+    ReadHandlerFunction<int16_t>,
+    ReadHandlerFunction<int32_t>,
+    ReadHandlerFunction<int64_t>,
+    DomainReadHandler
 >;
 
 
 using WriteHandler = std::variant<
     std::monostate,
-    WriteFunction<uint8_t>,
-    WriteFunction<uint16_t>,
-    WriteFunction<uint32_t>,
-    WriteFunction<uint64_t>,
-    WriteFunction<int8_t>,
-    WriteFunction<int16_t>,
-    WriteFunction<int32_t>,
-    WriteFunction<int64_t>
+    WriteHandlerFunction<uint8_t>,
+    WriteHandlerFunction<uint16_t>,
+    WriteHandlerFunction<uint32_t>,
+    WriteHandlerFunction<uint64_t>,
+    WriteHandlerFunction<int8_t>,
+    WriteHandlerFunction<int16_t>,
+    WriteHandlerFunction<int32_t>,
+    WriteHandlerFunction<int64_t>,
+    DomainWriteHandler
 >;
 
 template<typename OD>
@@ -55,24 +111,32 @@ public:
 private:
     static constexpr auto makeReadHandlerMap() -> ReadHandlerMap
     {
-        ConstexprMapBuilder<Address, ReadHandler, ReadHandlerCount> builder{};
-        for (const auto& [address, entry] : OD::map) {
-            if (entry.isReadable()) {
-                builder.insert(address, ReadHandler{});
+        if constexpr (requires { OD::readableAddresses; }) {
+            return ReadHandlerMap::fromSortedKeys(OD::readableAddresses);
+        } else {
+            ConstexprMapBuilder<Address, ReadHandler, ReadHandlerCount> builder{};
+            for (const auto& [address, entry] : OD::map) {
+                if (entry.isReadable()) {
+                    builder.insert(address, ReadHandler{});
+                }
             }
+            return builder.buildMap();
         }
-        return builder.buildMap();
     }
 
     static constexpr auto makeWriteHandlerMap() -> WriteHandlerMap
     {
-        ConstexprMapBuilder<Address, WriteHandler, WriteHandlerCount> builder{};
-        for (const auto& [address, entry] : OD::map) {
-            if (entry.isWritable()) {
-                builder.insert(address, WriteHandler{});
+        if constexpr (requires { OD::writableAddresses; }) {
+            return WriteHandlerMap::fromSortedKeys(OD::writableAddresses);
+        } else {
+            ConstexprMapBuilder<Address, WriteHandler, WriteHandlerCount> builder{};
+            for (const auto& [address, entry] : OD::map) {
+                if (entry.isWritable()) {
+                    builder.insert(address, WriteHandler{});
+                }
             }
+            return builder.buildMap();
         }
-        return builder.buildMap();
     }
 
     ReadHandlerMap readHandlers = makeReadHandlerMap();
@@ -89,10 +153,67 @@ public:
         return writeHandlers.lookup(address);
     }
 
+    /// Check if a handler is registered for any access direction of the object
+    constexpr bool hasHandler(Address address) const
+    {
+        const auto read = readHandlers.lookup(address);
+        const auto write = writeHandlers.lookup(address);
+        return (read && !std::holds_alternative<std::monostate>(*read)) ||
+            (write && !std::holds_alternative<std::monostate>(*write));
+    }
+
     template<Address address, typename ReturnT>
     constexpr void setReadHandler(ReturnT(*func)())
     {
-        ReadHandler handler = func;
+        registerReadHandler<address>(ReadHandlerFunction<ReturnT>{.function = func});
+    }
+
+    template<Address address, typename ReturnT>
+    constexpr void setReadHandler(ReturnT(*func)(void*))
+    {
+        registerReadHandler<address>(ReadHandlerFunction<ReturnT>{.contextFunction = func});
+    }
+
+    template<Address address, typename Param>
+    constexpr void setWriteHandler(SdoErrorCode(*func)(Param))
+    {
+        registerWriteHandler<address>(WriteHandlerFunction<Param>{.function = func});
+    }
+
+    template<Address address, typename Param>
+    constexpr void setWriteHandler(SdoErrorCode(*func)(void*, Param))
+    {
+        registerWriteHandler<address>(WriteHandlerFunction<Param>{.contextFunction = func});
+    }
+
+    template<Address address>
+    constexpr void setReadHandler(DomainReadFunction func)
+    {
+        registerReadHandler<address>(DomainReadHandler{.function = func});
+    }
+
+    template<Address address>
+    constexpr void setReadHandler(ContextDomainReadFunction func)
+    {
+        registerReadHandler<address>(DomainReadHandler{.contextFunction = func});
+    }
+
+    template<Address address>
+    constexpr void setWriteHandler(DomainWriteFunction func)
+    {
+        registerWriteHandler<address>(DomainWriteHandler{.function = func});
+    }
+
+    template<Address address>
+    constexpr void setWriteHandler(ContextDomainWriteFunction func)
+    {
+        registerWriteHandler<address>(DomainWriteHandler{.contextFunction = func});
+    }
+
+private:
+    template<Address address, typename Handler>
+    constexpr void registerReadHandler(Handler handler)
+    {
         constexpr auto entry = OD::map.lookup(address);
         static_assert(entry, "Object not found");
 
@@ -101,7 +222,7 @@ public:
             constexpr bool accessValid = entry->isReadable();
             static_assert(accessValid, "Cannot register read handler for write-only object");
 
-            constexpr auto handlerIndex = ReadHandler(static_cast<ReturnT(*)()>(nullptr)).index();
+            constexpr auto handlerIndex = ReadHandler(Handler{}).index();
             constexpr auto odIndex = static_cast<std::size_t>(entry->dataType);
             static_assert(odIndex == handlerIndex, "Invalid read handler type for entry");
 
@@ -111,10 +232,9 @@ public:
         }
     }
 
-    template<Address address, typename Param>
-    constexpr void setWriteHandler(SdoErrorCode(*func)(Param))
+    template<Address address, typename Handler>
+    constexpr void registerWriteHandler(Handler handler)
     {
-        WriteHandler handler = func;
         constexpr auto entry = OD::map.lookup(address);
         static_assert(entry, "Object not found");
 
@@ -124,7 +244,7 @@ public:
             static_assert(accessValid, "Cannot register write handler for read-only object");
 
             constexpr auto odIndex = static_cast<std::size_t>(entry->dataType);
-            constexpr auto handlerIndex = WriteHandler(static_cast<SdoErrorCode(*)(Param)>(nullptr)).index();
+            constexpr auto handlerIndex = WriteHandler(Handler{}).index();
             static_assert(odIndex == handlerIndex, "Invalid write handler type for entry");
 
             if constexpr (accessValid && (odIndex == handlerIndex)) {
@@ -135,24 +255,26 @@ public:
 };
 
 static_assert(ReadHandler(std::monostate{}).index() == size_t(DataType::Empty));
-static_assert(ReadHandler(ReadFunction<uint8_t >{}).index() == size_t(DataType::UInt8));
-static_assert(ReadHandler(ReadFunction<uint16_t>{}).index() == size_t(DataType::UInt16));
-static_assert(ReadHandler(ReadFunction<uint32_t>{}).index() == size_t(DataType::UInt32));
-static_assert(ReadHandler(ReadFunction<uint64_t>{}).index() == size_t(DataType::UInt64));
-static_assert(ReadHandler(ReadFunction< int8_t >{}).index() == size_t(DataType::Int8));
-static_assert(ReadHandler(ReadFunction< int16_t>{}).index() == size_t(DataType::Int16));
-static_assert(ReadHandler(ReadFunction< int32_t>{}).index() == size_t(DataType::Int32));
-static_assert(ReadHandler(ReadFunction< int64_t>{}).index() == size_t(DataType::Int64));
+static_assert(ReadHandler(ReadHandlerFunction<uint8_t >{}).index() == size_t(DataType::UInt8));
+static_assert(ReadHandler(ReadHandlerFunction<uint16_t>{}).index() == size_t(DataType::UInt16));
+static_assert(ReadHandler(ReadHandlerFunction<uint32_t>{}).index() == size_t(DataType::UInt32));
+static_assert(ReadHandler(ReadHandlerFunction<uint64_t>{}).index() == size_t(DataType::UInt64));
+static_assert(ReadHandler(ReadHandlerFunction< int8_t >{}).index() == size_t(DataType::Int8));
+static_assert(ReadHandler(ReadHandlerFunction< int16_t>{}).index() == size_t(DataType::Int16));
+static_assert(ReadHandler(ReadHandlerFunction< int32_t>{}).index() == size_t(DataType::Int32));
+static_assert(ReadHandler(ReadHandlerFunction< int64_t>{}).index() == size_t(DataType::Int64));
+static_assert(ReadHandler(DomainReadHandler{}).index() == size_t(DataType::Domain));
 
 static_assert(WriteHandler(std::monostate{}).index() == size_t(DataType::Empty));
-static_assert(WriteHandler(WriteFunction<uint8_t >{}).index() == size_t(DataType::UInt8));
-static_assert(WriteHandler(WriteFunction<uint16_t>{}).index() == size_t(DataType::UInt16));
-static_assert(WriteHandler(WriteFunction<uint32_t>{}).index() == size_t(DataType::UInt32));
-static_assert(WriteHandler(WriteFunction<uint64_t>{}).index() == size_t(DataType::UInt64));
-static_assert(WriteHandler(WriteFunction< int8_t >{}).index() == size_t(DataType::Int8));
-static_assert(WriteHandler(WriteFunction< int16_t>{}).index() == size_t(DataType::Int16));
-static_assert(WriteHandler(WriteFunction< int32_t>{}).index() == size_t(DataType::Int32));
-static_assert(WriteHandler(WriteFunction< int64_t>{}).index() == size_t(DataType::Int64));
+static_assert(WriteHandler(WriteHandlerFunction<uint8_t >{}).index() == size_t(DataType::UInt8));
+static_assert(WriteHandler(WriteHandlerFunction<uint16_t>{}).index() == size_t(DataType::UInt16));
+static_assert(WriteHandler(WriteHandlerFunction<uint32_t>{}).index() == size_t(DataType::UInt32));
+static_assert(WriteHandler(WriteHandlerFunction<uint64_t>{}).index() == size_t(DataType::UInt64));
+static_assert(WriteHandler(WriteHandlerFunction< int8_t >{}).index() == size_t(DataType::Int8));
+static_assert(WriteHandler(WriteHandlerFunction< int16_t>{}).index() == size_t(DataType::Int16));
+static_assert(WriteHandler(WriteHandlerFunction< int32_t>{}).index() == size_t(DataType::Int32));
+static_assert(WriteHandler(WriteHandlerFunction< int64_t>{}).index() == size_t(DataType::Int64));
+static_assert(WriteHandler(DomainWriteHandler{}).index() == size_t(DataType::Domain));
 
 template<typename OD>
 constexpr Address findMissingReadHandler(const HandlerMap<OD>& map)
@@ -182,7 +304,7 @@ constexpr Address findMissingWriteHandler(const HandlerMap<OD>& map)
     return Address{};
 }
 
-inline Value callReadHandler(ReadHandler h)
+inline Value callReadHandler(const ReadHandler& h, void* context)
 {
     static_assert(Value(std::monostate{}).index() == size_t(DataType::Empty));
 
@@ -190,45 +312,113 @@ inline Value callReadHandler(ReadHandler h)
     case DataType::Empty:
         return Value{};
     case DataType::UInt8:
-        return Value(std::get<ReadFunction<uint8_t>>(h)());
+        return Value(std::get<ReadHandlerFunction<uint8_t>>(h)(context));
     case DataType::UInt16:
-        return Value(std::get<ReadFunction<uint16_t>>(h)());
+        return Value(std::get<ReadHandlerFunction<uint16_t>>(h)(context));
     case DataType::UInt32:
-        return Value(std::get<ReadFunction<uint32_t>>(h)());
+        return Value(std::get<ReadHandlerFunction<uint32_t>>(h)(context));
     case DataType::UInt64:
-        return Value(std::get<ReadFunction<uint64_t>>(h)());
+        return Value(std::get<ReadHandlerFunction<uint64_t>>(h)(context));
     case DataType::Int8:
-        return Value(std::get<ReadFunction<int8_t>>(h)());
+        return Value(std::get<ReadHandlerFunction<int8_t>>(h)(context));
     case DataType::Int16:
-        return Value(std::get<ReadFunction<int16_t>>(h)());
+        return Value(std::get<ReadHandlerFunction<int16_t>>(h)(context));
     case DataType::Int32:
-        return Value(std::get<ReadFunction<int32_t>>(h)());
+        return Value(std::get<ReadHandlerFunction<int32_t>>(h)(context));
     case DataType::Int64:
-        return Value(std::get<ReadFunction<int64_t>>(h)());
+        return Value(std::get<ReadHandlerFunction<int64_t>>(h)(context));
+    case DataType::Domain:
+        // domains can't be represented as Value
+        return Value{};
     }
     return Value{};
 }
 
-inline SdoErrorCode callWriteHandler(WriteHandler h, Value value)
+/// Call read handler and store the result to data in CANopen byte order without constructing a Value
+/// \return number of bytes written
+inline std::size_t callReadHandler(const ReadHandler& h, void* context, uint8_t* data)
+{
+    const auto copy = [data](auto value) {
+        detail::storeLittleEndian(value, data);
+        return sizeof(value);
+    };
+
+    switch (DataType(h.index())) {
+    case DataType::UInt8:
+        return copy(std::get<ReadHandlerFunction<uint8_t>>(h)(context));
+    case DataType::UInt16:
+        return copy(std::get<ReadHandlerFunction<uint16_t>>(h)(context));
+    case DataType::UInt32:
+        return copy(std::get<ReadHandlerFunction<uint32_t>>(h)(context));
+    case DataType::UInt64:
+        return copy(std::get<ReadHandlerFunction<uint64_t>>(h)(context));
+    case DataType::Int8:
+        return copy(std::get<ReadHandlerFunction<int8_t>>(h)(context));
+    case DataType::Int16:
+        return copy(std::get<ReadHandlerFunction<int16_t>>(h)(context));
+    case DataType::Int32:
+        return copy(std::get<ReadHandlerFunction<int32_t>>(h)(context));
+    case DataType::Int64:
+        return copy(std::get<ReadHandlerFunction<int64_t>>(h)(context));
+    case DataType::Empty:
+    case DataType::Domain:
+        break;
+    }
+    return 0;
+}
+
+/// Decode the value from data and call write handler without constructing a Value
+inline SdoErrorCode callWriteHandler(const WriteHandler& h, void* context, const uint8_t* data)
+{
+    const auto call = [context, data]<typename T>(const WriteHandlerFunction<T>& function) {
+        return function(context, detail::loadLittleEndian<T>(data));
+    };
+
+    switch (DataType(h.index())) {
+    case DataType::UInt8:
+        return call(std::get<WriteHandlerFunction<uint8_t>>(h));
+    case DataType::UInt16:
+        return call(std::get<WriteHandlerFunction<uint16_t>>(h));
+    case DataType::UInt32:
+        return call(std::get<WriteHandlerFunction<uint32_t>>(h));
+    case DataType::UInt64:
+        return call(std::get<WriteHandlerFunction<uint64_t>>(h));
+    case DataType::Int8:
+        return call(std::get<WriteHandlerFunction<int8_t>>(h));
+    case DataType::Int16:
+        return call(std::get<WriteHandlerFunction<int16_t>>(h));
+    case DataType::Int32:
+        return call(std::get<WriteHandlerFunction<int32_t>>(h));
+    case DataType::Int64:
+        return call(std::get<WriteHandlerFunction<int64_t>>(h));
+    case DataType::Empty:
+    case DataType::Domain:
+        break;
+    }
+    return SdoErrorCode::GeneralError;
+}
+
+inline SdoErrorCode callWriteHandler(const WriteHandler& h, void* context, Value value)
 {
     switch (DataType(h.index())) {
     case DataType::UInt8:
-        return std::get<WriteFunction<uint8_t>>(h)(*std::get_if<uint8_t>(&value));
+        return std::get<WriteHandlerFunction<uint8_t>>(h)(context, *std::get_if<uint8_t>(&value));
     case DataType::UInt16:
-        return std::get<WriteFunction<uint16_t>>(h)(*std::get_if<uint16_t>(&value));
+        return std::get<WriteHandlerFunction<uint16_t>>(h)(context, *std::get_if<uint16_t>(&value));
     case DataType::UInt32:
-        return std::get<WriteFunction<uint32_t>>(h)(*std::get_if<uint32_t>(&value));
+        return std::get<WriteHandlerFunction<uint32_t>>(h)(context, *std::get_if<uint32_t>(&value));
     case DataType::UInt64:
-        return std::get<WriteFunction<uint64_t>>(h)(*std::get_if<uint64_t>(&value));
+        return std::get<WriteHandlerFunction<uint64_t>>(h)(context, *std::get_if<uint64_t>(&value));
     case DataType::Int8:
-        return std::get<WriteFunction<int8_t>>(h)(*std::get_if<int8_t>(&value));
+        return std::get<WriteHandlerFunction<int8_t>>(h)(context, *std::get_if<int8_t>(&value));
     case DataType::Int16:
-        return std::get<WriteFunction<int16_t>>(h)(*std::get_if<int16_t>(&value));
+        return std::get<WriteHandlerFunction<int16_t>>(h)(context, *std::get_if<int16_t>(&value));
     case DataType::Int32:
-        return std::get<WriteFunction<int32_t>>(h)(*std::get_if<int32_t>(&value));
+        return std::get<WriteHandlerFunction<int32_t>>(h)(context, *std::get_if<int32_t>(&value));
     case DataType::Int64:
-        return std::get<WriteFunction<int64_t>>(h)(*std::get_if<int64_t>(&value));
+        return std::get<WriteHandlerFunction<int64_t>>(h)(context, *std::get_if<int64_t>(&value));
     case DataType::Empty:
+    case DataType::Domain:
         break;
     }
     return SdoErrorCode::GeneralError;
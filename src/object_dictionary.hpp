@@ -5,10 +5,12 @@
 #include "generated/object_dictionary.hpp"
 
 #include <algorithm>
+#include <bit>
 #include <cstdint>
 #include <cstring>
 #include <numeric>
 #include <optional>
+#include <type_traits>
 #include <utility>
 #include <variant>
 
@@ -22,29 +24,84 @@ using Value = std::variant<std::monostate,
                             int8_t,  int16_t,  int32_t,  int64_t>;
 
 
+// Generated dictionaries provide precomputed entry counts and sorted address tables,
+// the fallbacks below support dictionaries only defining the entry map.
+
 template<typename Map>
 constexpr std::size_t readableEntryCount()
 {
-    const auto isReadable = [](const std::pair<Address, Entry>& elem) {
-        return elem.second.isReadable() ? 1u : 0u;
-    };
-    return std::transform_reduce(Map::map.begin(), Map::map.end(), 0u,
-                                 std::plus<>{},
-                                 isReadable);
+    if constexpr (requires { Map::ReadableEntryCount; }) {
+        return Map::ReadableEntryCount;
+    } else {
+        const auto isReadable = [](const std::pair<Address, Entry>& elem) {
+            return elem.second.isReadable() ? 1u : 0u;
+        };
+        return std::transform_reduce(Map::map.begin(), Map::map.end(), 0u,
+                                     std::plus<>{},
+                                     isReadable);
+    }
 }
 
 template<typename Map>
 constexpr std::size_t writableEntryCount()
 {
-    const auto isWritable = [](const std::pair<Address, Entry>& elem) {
-        return elem.second.isWritable() ? 1u : 0u;
-    };
-    return std::transform_reduce(Map::map.begin(), Map::map.end(), 0u,
-                                 std::plus<>{},
-                                 isWritable);
+    if constexpr (requires { Map::WritableEntryCount; }) {
+        return Map::WritableEntryCount;
+    } else {
+        const auto isWritable = [](const std::pair<Address, Entry>& elem) {
+            return elem.second.isWritable() ? 1u : 0u;
+        };
+        return std::transform_reduce(Map::map.begin(), Map::map.end(), 0u,
+                                     std::plus<>{},
+                                     isWritable);
+    }
 }
 
-inline size_t getDataTypeSize(DataType type)
+template<typename Map>
+constexpr std::size_t transmitPdoMappableEntryCount()
+{
+    if constexpr (requires { Map::TransmitPdoMappableEntryCount; }) {
+        return Map::TransmitPdoMappableEntryCount;
+    } else {
+        const auto isMappable = [](const std::pair<Address, Entry>& elem) {
+            return elem.second.isTransmitPdoMappable() ? 1u : 0u;
+        };
+        return std::transform_reduce(Map::map.begin(), Map::map.end(), 0u,
+                                     std::plus<>{},
+                                     isMappable);
+    }
+}
+
+/// Check if the object dictionary contains an object, used for registering optional objects
+template<typename Map>
+constexpr bool hasEntry(Address address)
+{
+    return Map::map.lookup(address).valid();
+}
+
+/// Number of receive PDOs, NrOfRXPDO from the EDS file or 4 if not specified
+template<typename Map>
+constexpr std::size_t receivePdoCount()
+{
+    if constexpr (requires { Map::ReceivePdoCount; }) {
+        return Map::ReceivePdoCount;
+    } else {
+        return 4;
+    }
+}
+
+/// Number of transmit PDOs, NrOfTXPDO from the EDS file or 4 if not specified
+template<typename Map>
+constexpr std::size_t transmitPdoCount()
+{
+    if constexpr (requires { Map::TransmitPdoCount; }) {
+        return Map::TransmitPdoCount;
+    } else {
+        return 4;
+    }
+}
+
+constexpr size_t getDataTypeSize(DataType type)
 {
     switch (type) {
     case DataType::Empty:
@@ -65,6 +122,8 @@ inline size_t getDataTypeSize(DataType type)
         return 4;
     case DataType::Int64:
         return 8;
+    case DataType::Domain:
+        return 0;
     }
     return 0;
 }
@@ -78,7 +137,8 @@ inline bool typeSupportsExpediteTransfer(DataType type)
 {
     return (type != DataType::Empty) &&
         (type != DataType::UInt64) &&
-        (type != DataType::Int64);
+        (type != DataType::Int64) &&
+        (type != DataType::Domain);
 }
 
 inline bool valueSupportsExpediteTransfer(const Value& value)
@@ -113,17 +173,92 @@ inline Value valueFromBytes(DataType type, const uint8_t* data)
             | (int64_t(data[4]) << 32) | (int64_t(data[5]) << 40)
             | (int64_t(data[6]) << 48) | (int64_t(data[7]) << 56));
     case DataType::Empty:
+    case DataType::Domain:
         return Value{};
     }
     return Value{};
 
 }
 
-inline void valueToBytes(Value value, uint8_t* data)
+namespace detail
 {
-    // TODO: hack
-    std::visit([data](auto value) {
+
+/// Store value in CANopen (little endian) byte order, a plain copy on little endian targets
+template<typename T>
+inline void storeLittleEndian(T value, uint8_t* data)
+{
+    if constexpr (std::endian::native == std::endian::little) {
         std::memcpy(data, &value, sizeof(value));
+    } else {
+        const auto bits = static_cast<std::make_unsigned_t<T>>(value);
+        for (std::size_t i = 0; i < sizeof(T); ++i) {
+            data[i] = uint8_t(bits >> (8 * i));
+        }
+    }
+}
+
+/// Load value stored in CANopen (little endian) byte order
+template<typename T>
+inline T loadLittleEndian(const uint8_t* data)
+{
+    if constexpr (std::endian::native == std::endian::little) {
+        T value;
+        std::memcpy(&value, data, sizeof(value));
+        return value;
+    } else {
+        std::make_unsigned_t<T> bits{};
+        for (std::size_t i = 0; i < sizeof(T); ++i) {
+            bits |= std::make_unsigned_t<T>(data[i]) << (8 * i);
+        }
+        return static_cast<T>(bits);
+    }
+}
+
+template<typename T>
+inline uint64_t valueDifference(const uint8_t* data0, const uint8_t* data1)
+{
+    // widening to 64 bit and subtracting modulo 2^64 yields the exact difference
+    using Wide = std::conditional_t<std::is_signed_v<T>, int64_t, uint64_t>;
+    const auto value0 = Wide(loadLittleEndian<T>(data0));
+    const auto value1 = Wide(loadLittleEndian<T>(data1));
+    return (value0 > value1) ? uint64_t(value0) - uint64_t(value1) : uint64_t(value1) - uint64_t(value0);
+}
+
+/// Absolute difference of two values stored in CANopen byte order, 0 for domains
+inline uint64_t valueDifference(DataType type, const uint8_t* data0, const uint8_t* data1)
+{
+    switch (type) {
+    case DataType::UInt8:
+        return valueDifference<uint8_t>(data0, data1);
+    case DataType::UInt16:
+        return valueDifference<uint16_t>(data0, data1);
+    case DataType::UInt32:
+        return valueDifference<uint32_t>(data0, data1);
+    case DataType::UInt64:
+        return valueDifference<uint64_t>(data0, data1);
+    case DataType::Int8:
+        return valueDifference<int8_t>(data0, data1);
+    case DataType::Int16:
+        return valueDifference<int16_t>(data0, data1);
+    case DataType::Int32:
+        return valueDifference<int32_t>(data0, data1);
+    case DataType::Int64:
+        return valueDifference<int64_t>(data0, data1);
+    case DataType::Empty:
+    case DataType::Domain:
+        return 0;
+    }
+    return 0;
+}
+
+}
+
+inline void valueToBytes(Value value, uint8_t* data)
+{
+    std::visit([data]<typename T>(T value) {
+        if constexpr (!std::is_same_v<T, std::monostate>) {
+            detail::storeLittleEndian(value, data);
+        }
     }, value);
 }
 
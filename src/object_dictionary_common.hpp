@@ -2,6 +2,7 @@
 #define MODM_CANOPEN_OBJECT_DICTIONARY_COMMON_HPP
 
 #include <cstdint>
+#include <variant>
 
 namespace modm_canopen
 {
@@ -12,6 +13,12 @@ struct Address
     uint8_t subindex;
 
     constexpr friend auto operator<=>(Address, Address) = default;
+
+    /// Key for the hash index of ConstexprMap
+    constexpr friend uint32_t constexprMapHash(Address address)
+    {
+        return (uint32_t(address.index) << 8) | address.subindex;
+    }
 };
 
 enum class DataType : uint8_t
@@ -24,7 +31,8 @@ enum class DataType : uint8_t
     Int8,
     Int16,
     Int32,
-    Int64
+    Int64,
+    Domain // variable size data accessed in chunks, see DomainReadFunction
 };
 
 enum class AccessType : uint8_t
@@ -60,6 +68,20 @@ struct Entry
     }
 };
 
+/// Member of the generated storage struct holding the value of an object, the index matches DataType
+template<typename Storage>
+using StorageMember = std::variant<std::monostate,
+                                   uint8_t Storage::*, uint16_t Storage::*, uint32_t Storage::*, uint64_t Storage::*,
+                                   int8_t Storage::*,  int16_t Storage::*,  int32_t Storage::*,  int64_t Storage::*>;
+
+/// Object accessed in the storage of the node unless the application registers a handler
+template<typename Storage>
+struct StorageBinding
+{
+    Address address;
+    StorageMember<Storage> member;
+};
+
 }
 
 #endif // MODM_CANOPEN_OBJECT_DICTIONARY_COMMON_HPP
@@ -7,6 +7,20 @@
 namespace modm_canopen
 {
 
+/// Maximum number of receive or transmit PDOs of a device
+constexpr std::size_t MaxPdoCount{512};
+
+/// Check for CAN identifiers reserved by CiA 301 that must not be used for PDOs
+constexpr bool isRestrictedPdoCanId(uint32_t canId)
+{
+    return (canId <= 0x07F)
+        || (canId >= 0x101 && canId <= 0x180)
+        || (canId >= 0x581 && canId <= 0x5FF)
+        || (canId >= 0x601 && canId <= 0x67F)
+        || (canId >= 0x6E0 && canId <= 0x6FF)
+        || (canId >= 0x701);
+}
+
 struct PdoMapping
 {
     Address address;
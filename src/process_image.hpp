@@ -0,0 +1,137 @@
+#ifndef CANOPEN_PROCESS_IMAGE_HPP
+#define CANOPEN_PROCESS_IMAGE_HPP
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+#include "handler_map.hpp"
+
+namespace modm_canopen
+{
+
+/// Publication counter of a ProcessImage, used by transmit PDOs to detect torn snapshots
+/// The sequence is odd while a new image is written.
+class ProcessImageBase
+{
+public:
+    /// Start reading a set of objects of the image
+    uint32_t beginRead() const
+    {
+        return sequence_.load(std::memory_order_acquire);
+    }
+
+    /// \return true if all objects read since beginRead() returned sequence belong to the same image
+    bool validate(uint32_t sequence) const
+    {
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return (sequence_.load(std::memory_order_relaxed) - (sequence & ~1u)) < 2;
+    }
+
+protected:
+    constexpr ProcessImageBase() = default;
+
+    std::atomic<uint32_t> sequence_{};
+};
+
+/// Set of object values published atomically by a single producer thread
+///
+/// The image is double-buffered: publish() writes the buffer not holding the latest image,
+/// readers copy the latest image and retry only if the producer started to overwrite it.
+/// Writers never wait for readers. Transmit PDOs packed while a new image is published are
+/// packed again, see CanopenNode::setProcessImage().
+template<typename Image>
+class ProcessImage : public ProcessImageBase
+{
+    static_assert(std::is_trivially_copyable_v<Image>, "Process image must be trivially copyable");
+
+public:
+    constexpr ProcessImage() = default;
+    ProcessImage(const ProcessImage&) = delete;
+    ProcessImage& operator=(const ProcessImage&) = delete;
+
+    /// Publish a complete set of values, must only be called by one thread
+    void publish(const Image& image)
+    {
+        std::array<uint32_t, WordCount> words{};
+        std::memcpy(words.data(), &image, sizeof(Image));
+
+        const uint32_t sequence = sequence_.load(std::memory_order_relaxed);
+        auto& buffer = buffers_[((sequence + 2) >> 1) & 1];
+        sequence_.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (std::size_t i = 0; i < WordCount; ++i) {
+            buffer[i].store(words[i], std::memory_order_relaxed);
+        }
+        sequence_.store(sequence + 2, std::memory_order_release);
+    }
+
+    /// \return latest published image, zero-initialized before the first publish()
+    Image read() const
+    {
+        std::array<uint32_t, WordCount> words{};
+        readWords(0, WordCount, words.data());
+
+        Image image;
+        std::memcpy(&image, words.data(), sizeof(Image));
+        return image;
+    }
+
+    /// \return member of the latest published image, only the words holding it are copied
+    template<auto member>
+    auto get() const
+    {
+        using T = std::remove_cvref_t<decltype(std::declval<const Image&>().*member)>;
+        const std::size_t offset = offsetOf<member>();
+        const std::size_t first = offset / 4;
+        // a member not aligned to 4 bytes can span one more word
+        std::array<uint32_t, (sizeof(T) + 3) / 4 + 1> words{};
+        readWords(first, (offset + sizeof(T) + 3) / 4 - first, words.data());
+
+        T value;
+        std::memcpy(&value, reinterpret_cast<const uint8_t*>(words.data()) + offset % 4, sizeof(T));
+        return value;
+    }
+
+private:
+    static constexpr std::size_t WordCount = (sizeof(Image) + 3) / 4;
+
+    /// Copy count words starting at first from the latest image
+    void readWords(std::size_t first, std::size_t count, uint32_t* words) const
+    {
+        uint32_t sequence;
+        do {
+            sequence = sequence_.load(std::memory_order_acquire);
+            const auto& buffer = buffers_[(sequence >> 1) & 1];
+            for (std::size_t i = 0; i < count; ++i) {
+                words[i] = buffer[first + i].load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            // the buffer is overwritten by the second publication after the latest one
+        } while ((sequence_.load(std::memory_order_relaxed) - (sequence & ~1u)) >= 3);
+    }
+
+    /// Byte offset of member in Image, folded to a constant by the compiler
+    template<auto member>
+    static std::size_t offsetOf()
+    {
+        const Image probe{};
+        return reinterpret_cast<const uint8_t*>(&(probe.*member)) - reinterpret_cast<const uint8_t*>(&probe);
+    }
+
+    std::array<std::array<std::atomic<uint32_t>, WordCount>, 2> buffers_{};
+};
+
+/// Register a read handler for an object stored in member of a ProcessImage
+/// image must have static storage duration, the member type must match the object type.
+template<Address address, auto& image, auto member, typename OD>
+constexpr void setProcessImageReadHandler(HandlerMap<OD>& map)
+{
+    map.template setReadHandler<address>(+[]() { return image.template get<member>(); });
+}
+
+}
+
+#endif // CANOPEN_PROCESS_IMAGE_HPP
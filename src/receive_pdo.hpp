@@ -2,8 +2,13 @@
 #define CANOPEN_RECEIVE_PDO_HPP
 
 #include "pdo_common.hpp"
+#include "handler_map.hpp"
 #include <array>
+#include <cstring>
+#include <optional>
+#include <span>
 #include <modm/architecture/interface/can_message.hpp>
+#include <modm/processing/timer/timestamp.hpp>
 
 namespace modm_canopen
 {
@@ -11,27 +16,67 @@ namespace modm_canopen
 enum class ReceiveMode
 {
     Async,
-    // TODO: OnSync
+    OnSync
+};
+
+/// Received PDO passed to a frame handler, see ReceivePdo::setFrameHandler()
+struct ReceivePdoFrame
+{
+    /// Reception time, for synchronous PDOs the reception of the payload committed on SYNC
+    modm::PreciseTimestamp timestamp;
+    std::span<const PdoMapping> mappings;
+    /// Decoded values in mapping order
+    std::span<const Value> values;
 };
 
 // TODO: de-duplicate code with TransmitPdo
 template<typename OD>
 class ReceivePdo
 {
+public:
+    /// Unpacks the mapped objects of a static mapping, see StaticPdoMapping
+    /// \return bit mask of the mappings written successfully
+    using StaticUnpackFunction = uint8_t(*)(void* context, const uint8_t* data);
+
+    /// Receives all values of a frame in one call instead of the write handlers of the objects
+    using FrameHandler = void(*)(void* context, const ReceivePdoFrame& frame);
+
 private:
     static constexpr std::size_t MaxMappingCount{8};
 
+    /// Mapped object resolved at activation time
+    struct UnpackEntry
+    {
+        WriteHandler handler;
+        uint8_t offset;
+    };
+
     bool active_{false};
+    void* context_{};
     uint32_t canId_{};
     uint_fast8_t mappingCount_{};
     std::array<PdoMapping, MaxMappingCount> mappings_{};
-    std::array<DataType, MaxMappingCount> mappingTypes_{};
+    std::array<UnpackEntry, MaxMappingCount> unpackPlan_{};
+    StaticUnpackFunction staticUnpack_{};
+    FrameHandler frameHandler_{};
+    std::array<DataType, MaxMappingCount> dataTypes_{};
+    uint8_t payloadSize_{};
+    uint8_t transmissionType_{0xFF};
+
+    // synchronous PDOs receive into one buffer while the other one is committed on SYNC
+    std::array<std::array<uint8_t, 8>, 2> syncBuffers_{};
+    std::array<modm::PreciseTimestamp, 2> syncTimestamps_{};
+    uint8_t syncBufferIndex_{};
+    bool syncBufferPending_{false};
 
 public:
     void setCanId(uint32_t canId);
 
-    SdoErrorCode setActive();
+    /// Validate mappings and resolve them into an unpack plan using the write handlers
+    /// \param context passed to handlers registered with a context parameter
+    SdoErrorCode setActive(const HandlerMap<OD>& handlers, void* context);
     void setInactive();
+    bool isActive() const;
 
     SdoErrorCode setMappingCount(uint_fast8_t count);
     uint_fast8_t mappingCount() const;
@@ -39,14 +84,42 @@ public:
     SdoErrorCode setMapping(uint_fast8_t index, PdoMapping mapping);
     PdoMapping mapping(uint_fast8_t index) const;
 
+    /// Replace the mapping by a mapping fixed at compile time
+    /// The PDO must be inactive. The mapping can't be changed afterwards.
+    SdoErrorCode setStaticMapping(std::span<const PdoMapping> mappings, StaticUnpackFunction unpack);
+    bool hasStaticMapping() const { return staticUnpack_ != nullptr; }
+
+    /// Pass every received frame to handler instead of the write handlers, nullptr to disable
+    /// The handler is called with the context passed to setActive(). Objects are not written
+    /// and no value change is reported for them.
+    void setFrameHandler(FrameHandler handler) { frameHandler_ = handler; }
+    bool hasFrameHandler() const { return frameHandler_ != nullptr; }
+
+    /// Message identifier is not checked, it must match canId()
+    /// The callback is called with the address of every successfully written object.
+    /// Synchronous PDOs buffer the payload until the next call to sync().
+    /// \param timestamp reception time passed to the frame handler
+    template<typename Callback>
+    void processMessage(const modm::can::Message& message, modm::PreciseTimestamp timestamp, Callback&& cb);
+
+    /// Commit the last payload received before the SYNC to the write handlers
     template<typename Callback>
-    void processMessage(const modm::can::Message& message, Callback&& cb);
+    void sync(Callback&& cb);
+
+    /// 0-240: synchronous, 0xFE/0xFF: asynchronous
+    SdoErrorCode setTransmissionType(uint8_t type);
+    uint8_t transmissionType() const;
+    ReceiveMode receiveMode() const;
 
     uint32_t cobId() const { return active_ ? canId_ : (canId_ | 0x8000'0000); }
     uint32_t canId() const { return canId_; }
 private:
     SdoErrorCode validateMapping(PdoMapping mapping);
     SdoErrorCode validateMappings();
+    SdoErrorCode buildUnpackPlan(const HandlerMap<OD>& handlers);
+
+    template<typename Callback>
+    void unpack(const uint8_t* data, modm::PreciseTimestamp timestamp, Callback&& cb);
 };
 
 }
@@ -2,7 +2,9 @@
 #define CANOPEN_RECEIVE_PDO_CONFIGURATOR_HPP
 
 #include <cstdint>
+#include <utility>
 #include "object_dictionary_common.hpp"
+#include "pdo_common.hpp"
 
 namespace modm_canopen
 {
@@ -11,51 +13,53 @@ template<typename Device>
 class ReceivePdoConfigurator
 {
 public:
-    template<uint8_t pdo>
+    template<uint16_t pdo>
     constexpr void registerPdoConfigObjects(Device::Map& map)
     {
-        auto& rpdo = Device::receivePdos_[pdo];
         // highest sub-index supported
         map.template setReadHandler<Address{0x1400 + pdo, 0}>(
             +[]() -> uint8_t { return 2; });
 
         // RPDO COB-ID
         map.template setReadHandler<Address{0x1400 + pdo, 1}>(
-            +[]() -> uint32_t { return rpdo.cobId(); });
+            +[](void* context) -> uint32_t { return receivePdo(context, pdo).cobId(); });
 
         map.template setWriteHandler<Address{0x1400 + pdo, 1}>(
-            +[](uint32_t cobId) { return setReceivePdoCobId(pdo, cobId); });
+            +[](void* context, uint32_t cobId) {
+                return setReceivePdoCobId(*static_cast<Device*>(context), pdo, cobId);
+            });
 
-        // Transmission type, only async supported for now
+        // Transmission type, 0-240: sync, 0xFE/0xFF: async
         map.template setReadHandler<Address{0x1400 + pdo, 2}>(
-            // 0xFF: async
-            +[]() -> uint8_t { return 0xFF; });
+            +[](void* context) -> uint8_t { return receivePdo(context, pdo).transmissionType(); });
+
         map.template setWriteHandler<Address{0x1400 + pdo, 2}>(
-            // 0xFF: async
-            +[](uint8_t transmitMode) -> SdoErrorCode { return transmitMode == 0xFF ? SdoErrorCode::NoError : SdoErrorCode::UnsupportedAccess; });
+            +[](void* context, uint8_t type) { return receivePdo(context, pdo).setTransmissionType(type); });
     }
 
-    template<uint8_t pdo, uint8_t mappingIndex>
+    template<uint16_t pdo, uint8_t mappingIndex>
     constexpr void registerMappingObjects(Device::Map& map)
     {
-        auto& rpdo = Device::receivePdos_[pdo];
         map.template setReadHandler<Address{0x1600 + pdo, mappingIndex + 1}>(
-            +[]() -> uint32_t { return rpdo.mapping(mappingIndex).encode(); });
+            +[](void* context) -> uint32_t {
+                return receivePdo(context, pdo).mapping(mappingIndex).encode();
+            });
 
         map.template setWriteHandler<Address{0x1600 + pdo, mappingIndex + 1}>(
-            +[](uint32_t mapping) { return rpdo.setMapping(mappingIndex, PdoMapping::decode(mapping)); });
+            +[](void* context, uint32_t mapping) {
+                return receivePdo(context, pdo).setMapping(mappingIndex, PdoMapping::decode(mapping));
+            });
     }
 
-    template<uint8_t pdo>
+    template<uint16_t pdo>
     constexpr void registerMappingConfigObjects(Device::Map& map)
     {
-        auto& rpdos = Device::receivePdos_;
         // mapping count
         map.template setReadHandler<Address{0x1600 + pdo, 0}>(
-            +[]() -> uint8_t { return rpdos[pdo].mappingCount(); });
+            +[](void* context) -> uint8_t { return receivePdo(context, pdo).mappingCount(); });
 
         map.template setWriteHandler<Address{0x1600 + pdo, 0}>(
-            +[](uint8_t count) { return rpdos[pdo].setMappingCount(count); });
+            +[](void* context, uint8_t count) { return receivePdo(context, pdo).setMappingCount(count); });
         registerMappingObjects<pdo, 0>(map);
         registerMappingObjects<pdo, 1>(map);
         registerMappingObjects<pdo, 2>(map);
@@ -68,33 +72,46 @@ public:
 
     constexpr void registerHandlers(Device::Map& map)
     {
-        registerPdoConfigObjects<0>(map);
-        registerPdoConfigObjects<1>(map);
-        registerPdoConfigObjects<2>(map);
-        registerPdoConfigObjects<3>(map);
-        registerMappingConfigObjects<0>(map);
-        registerMappingConfigObjects<1>(map);
-        registerMappingConfigObjects<2>(map);
-        registerMappingConfigObjects<3>(map);
+        registerPdos(map, std::make_index_sequence<Device::ReceivePdoCount>{});
     }
 
 private:
-    static SdoErrorCode setReceivePdoCobId(uint_fast8_t index, uint32_t cobId)
+    template<std::size_t... pdos>
+    constexpr void registerPdos(Device::Map& map, std::index_sequence<pdos...>)
+    {
+        (registerPdoConfigObjects<pdos>(map), ...);
+        (registerMappingConfigObjects<pdos>(map), ...);
+    }
+
+    static auto receivePdo(void* context, std::size_t index) -> auto&
+    {
+        return static_cast<Device*>(context)->receivePdos_[index];
+    }
+
+    static SdoErrorCode setReceivePdoCobId(Device& device, std::size_t index, uint32_t cobId)
     {
-        auto& rpdo = Device::receivePdos_[index];
-        const uint32_t canId = 0x100 * (2 + index) + Device::nodeId();
+        auto& rpdo = device.receivePdos_[index];
         const uint32_t canIdMask = (1u << 30) - 1;
-        // changing can id is not supported
-        if ((cobId & canIdMask) != canId) {
+        const uint32_t canId = cobId & canIdMask;
+        const bool enabled = !(cobId & (1u << 31));
+        if (enabled && isRestrictedPdoCanId(canId)) {
             return SdoErrorCode::InvalidValue;
         }
-        const bool enabled = !(cobId & (1u << 31));
+        // the can id can only be changed while the PDO is disabled
+        if (canId != rpdo.canId()) {
+            if (rpdo.isActive()) {
+                return SdoErrorCode::InvalidValue;
+            }
+            rpdo.setCanId(canId);
+        }
+        SdoErrorCode result = SdoErrorCode::NoError;
         if (enabled) {
-            return rpdo.setActive();
+            result = rpdo.setActive(Device::accessHandlers, &device);
         } else {
             rpdo.setInactive();
-            return SdoErrorCode::NoError;
         }
+        device.updateDispatchTable();
+        return result;
     }
 };
 
@@ -12,12 +12,23 @@ void ReceivePdo<OD>::setCanId(uint32_t canId)
 }
 
 template<typename OD>
-SdoErrorCode ReceivePdo<OD>::setActive()
+SdoErrorCode ReceivePdo<OD>::setActive(const HandlerMap<OD>& handlers, void* context)
 {
-    if(const auto error = validateMappings(); error != SdoErrorCode::NoError) {
-        return error;
+    // static mappings are validated at compile time
+    if (!staticUnpack_) {
+        if(const auto error = validateMappings(); error != SdoErrorCode::NoError) {
+            return error;
+        }
+        if(const auto error = buildUnpackPlan(handlers); error != SdoErrorCode::NoError) {
+            return error;
+        }
     }
 
+    for (uint_fast8_t i = 0; i < mappingCount_; ++i) {
+        dataTypes_[i] = OD::map.lookup(mappings_[i].address)->dataType;
+    }
+    syncBufferPending_ = false;
+    context_ = context;
     active_ = true;
     return SdoErrorCode::NoError;
 }
@@ -26,12 +37,19 @@ template<typename OD>
 void ReceivePdo<OD>::setInactive()
 {
     active_ = false;
+    syncBufferPending_ = false;
+}
+
+template<typename OD>
+bool ReceivePdo<OD>::isActive() const
+{
+    return active_;
 }
 
 template<typename OD>
 SdoErrorCode ReceivePdo<OD>::setMappingCount(uint_fast8_t count)
 {
-    if (active_ || count > MaxMappingCount) {
+    if (active_ || staticUnpack_ || count > MaxMappingCount) {
         return SdoErrorCode::UnsupportedAccess;
     }
 
@@ -41,8 +59,6 @@ SdoErrorCode ReceivePdo<OD>::setMappingCount(uint_fast8_t count)
         if (error != SdoErrorCode::NoError) {
             return error;
         }
-        const auto entry = OD::map.lookup(mappings_[i].address);
-        mappingTypes_[i] = entry->dataType;
         totalSize += mappings_[i].bitLength;
     }
     if (totalSize > 8*8) {
@@ -62,6 +78,10 @@ uint_fast8_t ReceivePdo<OD>::mappingCount() const
 template<typename OD>
 SdoErrorCode ReceivePdo<OD>::setMapping(uint_fast8_t index, PdoMapping mapping)
 {
+    // the unpack plan of an active PDO would be outdated
+    if (active_ || staticUnpack_) {
+        return SdoErrorCode::UnsupportedAccess;
+    }
     const auto error = validateMapping(mapping);
     if (error == SdoErrorCode::NoError) {
         mappings_[index] = mapping;
@@ -75,30 +95,110 @@ PdoMapping ReceivePdo<OD>::mapping(uint_fast8_t index) const
     return mappings_[index];
 }
 
+template<typename OD>
+SdoErrorCode ReceivePdo<OD>::setStaticMapping(std::span<const PdoMapping> mappings, StaticUnpackFunction unpack)
+{
+    if (active_ || mappings.size() > MaxMappingCount) {
+        return SdoErrorCode::UnsupportedAccess;
+    }
+    unsigned totalSize = 0;
+    for (std::size_t i = 0; i < mappings.size(); ++i) {
+        mappings_[i] = mappings[i];
+        totalSize += mappings[i].bitLength;
+    }
+    mappingCount_ = mappings.size();
+    payloadSize_ = totalSize / 8;
+    staticUnpack_ = unpack;
+    return SdoErrorCode::NoError;
+}
+
 template<typename OD>
 template<typename Callback>
-void ReceivePdo<OD>::processMessage(const modm::can::Message& message, Callback&& cb)
+void ReceivePdo<OD>::processMessage(const modm::can::Message& message,
+                                    modm::PreciseTimestamp timestamp, Callback&& cb)
 {
-    if (message.identifier != canId_) {
+    if (!active_ || payloadSize_ > message.length) {
         return;
     }
-    if (active_ && mappingCount_ > 0) {
-        std::size_t totalDataSize = 0;
+    if (receiveMode() == ReceiveMode::OnSync) {
+        std::memcpy(syncBuffers_[syncBufferIndex_].data(), message.data, payloadSize_);
+        syncTimestamps_[syncBufferIndex_] = timestamp;
+        syncBufferPending_ = true;
+    } else {
+        unpack(message.data, timestamp, std::forward<Callback>(cb));
+    }
+}
+
+template<typename OD>
+template<typename Callback>
+void ReceivePdo<OD>::sync(Callback&& cb)
+{
+    if (!active_ || !syncBufferPending_) {
+        return;
+    }
+    const auto& buffer = syncBuffers_[syncBufferIndex_];
+    const auto timestamp = syncTimestamps_[syncBufferIndex_];
+    syncBufferIndex_ ^= 1;
+    syncBufferPending_ = false;
+    unpack(buffer.data(), timestamp, std::forward<Callback>(cb));
+}
+
+template<typename OD>
+template<typename Callback>
+void ReceivePdo<OD>::unpack(const uint8_t* data, modm::PreciseTimestamp timestamp, Callback&& cb)
+{
+    if (frameHandler_) {
+        std::array<Value, MaxMappingCount> values{};
+        uint8_t offset = 0;
         for (uint_fast8_t i = 0; i < mappingCount_; ++i) {
-            totalDataSize += mappings_[i].bitLength / 8;
-        }
-        if(totalDataSize > message.length) {
-            return;
+            values[i] = valueFromBytes(dataTypes_[i], data + offset);
+            offset += mappings_[i].bitLength / 8;
         }
-        std::size_t index = 0;
+        frameHandler_(context_, ReceivePdoFrame{
+            .timestamp = timestamp,
+            .mappings = std::span(mappings_.data(), mappingCount_),
+            .values = std::span(values.data(), mappingCount_)
+        });
+        return;
+    }
+    if (staticUnpack_) {
+        const uint8_t written = staticUnpack_(context_, data);
         for (uint_fast8_t i = 0; i < mappingCount_; ++i) {
-            const auto address = mappings_[i].address;
-            const auto size = mappings_[i].bitLength / 8;
-            const auto value = valueFromBytes(mappingTypes_[i], message.data + index);
-            std::forward<Callback>(cb)(address, value);
-            index += size;
+            if (written & (1u << i)) {
+                std::forward<Callback>(cb)(mappings_[i].address);
+            }
         }
+        return;
     }
+    for (uint_fast8_t i = 0; i < mappingCount_; ++i) {
+        const auto& entry = unpackPlan_[i];
+        if (callWriteHandler(entry.handler, context_, data + entry.offset) == SdoErrorCode::NoError) {
+            std::forward<Callback>(cb)(mappings_[i].address);
+        }
+    }
+}
+
+template<typename OD>
+SdoErrorCode ReceivePdo<OD>::setTransmissionType(uint8_t type)
+{
+    if (type > 240 && type != 0xFE && type != 0xFF) {
+        return SdoErrorCode::InvalidValue;
+    }
+    transmissionType_ = type;
+    syncBufferPending_ = false;
+    return SdoErrorCode::NoError;
+}
+
+template<typename OD>
+uint8_t ReceivePdo<OD>::transmissionType() const
+{
+    return transmissionType_;
+}
+
+template<typename OD>
+ReceiveMode ReceivePdo<OD>::receiveMode() const
+{
+    return (transmissionType_ <= 240) ? ReceiveMode::OnSync : ReceiveMode::Async;
 }
 
 template<typename OD>
@@ -107,6 +207,22 @@ SdoErrorCode ReceivePdo<OD>::validateMappings()
     return SdoErrorCode::NoError;
 }
 
+template<typename OD>
+SdoErrorCode ReceivePdo<OD>::buildUnpackPlan(const HandlerMap<OD>& handlers)
+{
+    uint8_t offset = 0;
+    for (uint_fast8_t i = 0; i < mappingCount_; ++i) {
+        const auto handler = handlers.lookupWriteHandler(mappings_[i].address);
+        if (!handler || std::holds_alternative<std::monostate>(*handler)) {
+            return SdoErrorCode::PdoMappingError;
+        }
+        unpackPlan_[i] = UnpackEntry{*handler, offset};
+        offset += mappings_[i].bitLength / 8;
+    }
+    payloadSize_ = offset;
+    return SdoErrorCode::NoError;
+}
+
 template<typename OD>
 SdoErrorCode ReceivePdo<OD>::validateMapping(PdoMapping mapping)
 {
@@ -9,14 +9,24 @@ namespace modm_canopen
 enum class SdoErrorCode : uint32_t
 {
     NoError = 0,
+    ToggleBitNotAlternated = 0x0503'0000,
+    ProtocolTimedOut = 0x0504'0000,
+    InvalidCommandSpecifier = 0x0504'0001,
+    InvalidBlockSize = 0x0504'0002,
+    InvalidSequenceNumber = 0x0504'0003,
+    CrcError = 0x0504'0004,
     UnsupportedAccess = 0x0601'0000,
     ReadOfWriteOnlyObject = 0x0601'0001,
     WriteOfReadOnlyObject = 0x0601'0002,
     ObjectDoesNotExist = 0x0602'0000,
     PdoMappingError = 0x0604'0041,
     MappingsExceedPdoLength = 0x0604'0042,
+    LengthMismatch = 0x0607'0010,
+    LengthTooHigh = 0x0607'0012,
+    LengthTooLow = 0x0607'0013,
     InvalidValue = 0x0609'0030,
-    GeneralError = 0x0800'0000
+    GeneralError = 0x0800'0000,
+    LocalControl = 0x0800'0021
     // TODO: add error codes
 };
 
@@ -1,8 +1,13 @@
 #ifndef CANOPEN_SDO_SERVER_HPP
 #define CANOPEN_SDO_SERVER_HPP
 
+#include <array>
+#include <span>
 #include <modm/architecture/interface/can_message.hpp>
+#include <modm/architecture/interface/clock.hpp>
+#include <modm/processing/timer/timestamp.hpp>
 #include "object_dictionary.hpp"
+#include "handler_map.hpp"
 
 namespace modm_canopen
 {
@@ -13,20 +18,141 @@ class SdoServer
 public:
     using ObjectDictionary = Device::ObjectDictionary;
 
+    static constexpr uint8_t MaxBlockSize{127};
+
+    constexpr explicit SdoServer(Device& device) : device_{&device} {}
+
     uint8_t nodeId() const;
     void setNodeId(uint8_t id);
 
+    /// Set number of segments per block requested from the client in block downloads
+    SdoErrorCode setBlockSize(uint8_t segments);
+    uint8_t blockSize() const;
+
+    /// Set time without request from the client after which a transfer is aborted
+    void setTransferTimeout(modm::PreciseDuration timeout);
+    modm::PreciseDuration transferTimeout() const;
+
+    /// Message identifier is not checked, it must be the SDO request COB-ID of the node
     template<typename MessageCallback>
-    static void processMessage(const modm::can::Message& request,
-                               MessageCallback&& responseCallback);
+    void processMessage(const modm::can::Message& request,
+                        MessageCallback&& responseCallback);
+
+    /// Abort timed out transfers
+    /// \return time until the active transfer times out, PreciseDuration::max() if idle
+    template<typename MessageCallback>
+    modm::PreciseDuration update(MessageCallback&& cb);
 
 private:
-    static inline uint8_t nodeId_{};
+    enum class State : uint8_t
+    {
+        Idle,
+        SegmentedDownload,
+        SegmentedUpload,
+        BlockDownload,
+        BlockDownloadEnd,
+        BlockUploadStart,
+        BlockUpload,
+        BlockUploadEnd
+    };
+
+    /// State of the active non-expedited transfer
+    struct Transfer
+    {
+        Address address{};
+        DomainReadHandler domainRead{};
+        DomainWriteHandler domainWrite{};
+        bool sizeIndicated{false};
+        std::size_t size{};
+        // bytes transferred, for uploads only acknowledged bytes
+        std::size_t offset{};
+        // value of non-domain objects
+        std::array<uint8_t, 8> buffer{};
+        bool crcEnabled{false};
+        uint16_t crc{};
+        uint8_t blockSize{};
+        // last sequence number received in order (download) or sent (upload)
+        uint8_t sequence{};
+        // expected toggle bit of the next segmented transfer request
+        bool toggle{false};
+
+        // download: last segment is held back until the number of valid bytes is known
+        std::array<uint8_t, 7> pendingSegment{};
+        bool segmentPending{false};
+        bool lastSegmentReceived{false};
+
+        // upload: block is re-read from the object on retransmission
+        std::size_t blockOffset{};
+        std::size_t blockEnd{};
+        uint16_t blockCrc{};
+        uint8_t lastSegmentSize{};
+        bool lastSegmentSent{false};
+    };
+
+    Device* device_;
+    uint8_t nodeId_{};
+    uint8_t blockSize_{MaxBlockSize};
+    State state_{State::Idle};
+    Transfer transfer_{};
+    modm::PreciseDuration transferTimeout_{std::chrono::seconds{1}};
+    modm::PreciseTimestamp lastRequest_{};
+
+    template<typename C>
+    void processInitiate(const modm::can::Message& request, C&& cb);
+
+    template<typename C>
+    void initiateUpload(Address address, C&& cb);
+
+    template<typename C>
+    void initiateExpeditedDownload(Address address, const modm::can::Message& request, C&& cb);
+
+    template<typename C>
+    void initiateSegmentedDownload(Address address, const modm::can::Message& request, C&& cb);
+
+    template<typename C>
+    void processDownloadSegment(const modm::can::Message& request, C&& cb);
+
+    template<typename C>
+    void processUploadSegment(const modm::can::Message& request, C&& cb);
+
+    template<typename C>
+    void initiateBlockDownload(Address address, const modm::can::Message& request, C&& cb);
+
+    template<typename C>
+    void processBlockDownloadSegment(const modm::can::Message& request, C&& cb);
+
+    template<typename C>
+    void processBlockDownloadEnd(const modm::can::Message& request, C&& cb);
+
+    template<typename C>
+    void initiateBlockUpload(Address address, const modm::can::Message& request, C&& cb);
+
+    template<typename C>
+    void processBlockUploadAck(const modm::can::Message& request, C&& cb);
+
+    template<typename C>
+    void sendBlock(C&& cb);
+
+    template<typename C>
+    void abortTransfer(Address address, SdoErrorCode error, C&& cb);
+
+    /// Return to idle, notify the domain write handler of an unfinished download
+    void cancelTransfer();
+
+    SdoErrorCode beginUpload(Address address);
+    std::size_t readUpload(std::size_t offset, std::span<uint8_t> data);
+
+    SdoErrorCode beginDownload(Address address, bool sizeIndicated, std::size_t size);
+    SdoErrorCode writeDownload(std::span<const uint8_t> data, bool complete);
 };
 
 namespace detail
 {
-    inline auto uploadResponse(uint8_t nodeId, Address address, const Value& value)
+    inline auto sdoResponse(uint8_t nodeId, uint8_t command) -> modm::can::Message;
+
+    inline auto sdoResponse(uint8_t nodeId, uint8_t command, Address address) -> modm::can::Message;
+
+    inline auto uploadResponse(uint8_t nodeId, Address address, std::span<const uint8_t> data)
         -> modm::can::Message;
 
     inline auto downloadResponse(uint8_t nodeId, Address address)
@@ -34,10 +160,13 @@ namespace detail
 
     inline auto transferAbort(uint8_t nodeId, Address address, SdoErrorCode error)
         -> modm::can::Message;
+
+    /// CRC-16-CCITT as used by SDO block transfers
+    inline uint16_t sdoCrc(uint16_t crc, std::span<const uint8_t> data);
 };
 
 }
 
 #include "sdo_server_impl.hpp"
 
-#endif // CANOPEN_CANOPEN_DEVICE
+#endif // CANOPEN_SDO_SERVER_HPP
@@ -5,52 +5,627 @@
 namespace modm_canopen
 {
 
+namespace detail
+{
+    constexpr uint8_t commandSpecifierMask    = 0b111'0'00'0'0;
+    constexpr uint8_t commandDownload         = 0b001'0'00'0'0;
+    constexpr uint8_t commandUpload           = 0b010'0'00'0'0;
+    constexpr uint8_t commandAbort            = 0b100'0'00'0'0;
+    constexpr uint8_t commandBlockUpload      = 0b101'0'00'0'0;
+    constexpr uint8_t commandBlockDownload    = 0b110'0'00'0'0;
+
+    constexpr uint8_t commandDownloadSegment  = 0b000'0'00'0'0;
+    constexpr uint8_t commandUploadSegment    = 0b011'0'00'0'0;
+
+    constexpr uint8_t expedited               = 0b000'0'00'1'0;
+    constexpr uint8_t sizeIndicated           = 0b000'0'00'0'1;
+    constexpr uint8_t toggleBit               = 0b000'1'00'0'0;
+    constexpr uint8_t noMoreSegments          = 0b000'0'00'0'1;
+
+    constexpr uint8_t blockCrcSupported       = 0b000'0'01'0'0;
+    constexpr uint8_t blockSizeIndicated      = 0b000'0'00'1'0;
+    constexpr uint8_t blockUploadSubcommand   = 0b111'0'00'1'1;
+    constexpr uint8_t blockDownloadSubcommand = 0b111'0'00'0'1;
+    constexpr uint8_t blockUploadInitiate     = 0b101'0'00'0'0;
+    constexpr uint8_t blockUploadEnd          = 0b101'0'00'0'1;
+    constexpr uint8_t blockUploadAck          = 0b101'0'00'1'0;
+    constexpr uint8_t blockUploadStart        = 0b101'0'00'1'1;
+    constexpr uint8_t blockDownloadInitiate   = 0b110'0'00'0'0;
+    constexpr uint8_t blockDownloadEnd        = 0b110'0'00'0'1;
+    constexpr uint8_t blockLastSegment        = 0b100'0'00'0'0;
+
+    inline uint32_t readUInt32(const uint8_t* data)
+    {
+        return data[0] | (data[1] << 8) | (data[2] << 16) | (uint32_t(data[3]) << 24);
+    }
+
+    constexpr auto makeSdoCrcTable()
+    {
+        std::array<uint16_t, 256> table{};
+        for (unsigned i = 0; i < 256; ++i) {
+            uint16_t crc = i << 8;
+            for (int bit = 0; bit < 8; ++bit) {
+                crc = (crc & 0x8000) ? ((crc << 1) ^ 0x1021) : (crc << 1);
+            }
+            table[i] = crc;
+        }
+        return table;
+    }
+
+    inline constexpr auto sdoCrcTable = makeSdoCrcTable();
+}
+
 template<typename Device>
 template<typename C>
 void SdoServer<Device>::processMessage(const modm::can::Message& request,
                                        C&& cb)
 {
-    constexpr uint8_t commandUpload           = 0b010'0'00'0'0;
-    constexpr uint8_t commandUploadMask       = 0b111'0'00'0'0;
-    constexpr uint8_t commandExpediteDownload = 0b001'0'00'1'0;
-    constexpr uint8_t commandDownloadMask     = 0b111'0'00'1'0;
-    constexpr uint8_t sizeIndicated           = 0b000'0'00'0'1;
+    if (request.getLength() != 8) {
+        return;
+    }
+    const uint8_t command = request.data[0];
+    if (command == detail::commandAbort) {
+        cancelTransfer();
+        return;
+    }
+    lastRequest_ = modm::chrono::micro_clock::now();
+
+    switch (state_) {
+    case State::Idle:
+        processInitiate(request, std::forward<C>(cb));
+        break;
+    case State::SegmentedDownload:
+        processDownloadSegment(request, std::forward<C>(cb));
+        break;
+    case State::SegmentedUpload:
+        processUploadSegment(request, std::forward<C>(cb));
+        break;
+    case State::BlockDownload:
+        processBlockDownloadSegment(request, std::forward<C>(cb));
+        break;
+    case State::BlockDownloadEnd:
+        processBlockDownloadEnd(request, std::forward<C>(cb));
+        break;
+    case State::BlockUploadStart:
+        if (command == detail::blockUploadStart) {
+            state_ = State::BlockUpload;
+            sendBlock(std::forward<C>(cb));
+        } else {
+            abortTransfer(transfer_.address, SdoErrorCode::InvalidCommandSpecifier, std::forward<C>(cb));
+        }
+        break;
+    case State::BlockUpload:
+        processBlockUploadAck(request, std::forward<C>(cb));
+        break;
+    case State::BlockUploadEnd:
+        if (command == detail::blockUploadEnd) {
+            state_ = State::Idle;
+        } else {
+            abortTransfer(transfer_.address, SdoErrorCode::InvalidCommandSpecifier, std::forward<C>(cb));
+        }
+        break;
+    }
+}
+
+template<typename Device>
+template<typename C>
+modm::PreciseDuration SdoServer<Device>::update(C&& cb)
+{
+    if (state_ == State::Idle) {
+        return modm::PreciseDuration::max();
+    }
+    const auto elapsed = modm::chrono::micro_clock::now() - lastRequest_;
+    if (elapsed >= transferTimeout_) {
+        abortTransfer(transfer_.address, SdoErrorCode::ProtocolTimedOut, std::forward<C>(cb));
+        return modm::PreciseDuration::max();
+    }
+    return transferTimeout_ - elapsed;
+}
+
+template<typename Device>
+template<typename C>
+void SdoServer<Device>::processInitiate(const modm::can::Message& request, C&& cb)
+{
+    const Address address {
+        .index = uint16_t((request.data[2] << 8) | request.data[1]),
+        .subindex = request.data[3]
+    };
+    const uint8_t command = request.data[0];
+
+    switch (command & detail::commandSpecifierMask) {
+    case detail::commandUpload:
+        initiateUpload(address, std::forward<C>(cb));
+        break;
+    case detail::commandDownload:
+        if (command & detail::expedited) {
+            initiateExpeditedDownload(address, request, std::forward<C>(cb));
+        } else {
+            initiateSegmentedDownload(address, request, std::forward<C>(cb));
+        }
+        break;
+    case detail::commandBlockUpload:
+        if ((command & detail::blockUploadSubcommand) == detail::blockUploadInitiate) {
+            initiateBlockUpload(address, request, std::forward<C>(cb));
+        } else {
+            abortTransfer(address, SdoErrorCode::InvalidCommandSpecifier, std::forward<C>(cb));
+        }
+        break;
+    case detail::commandBlockDownload:
+        if ((command & detail::blockDownloadSubcommand) == detail::blockDownloadInitiate) {
+            initiateBlockDownload(address, request, std::forward<C>(cb));
+        } else {
+            abortTransfer(address, SdoErrorCode::InvalidCommandSpecifier, std::forward<C>(cb));
+        }
+        break;
+    default:
+        abortTransfer(address, SdoErrorCode::InvalidCommandSpecifier, std::forward<C>(cb));
+    }
+}
+
+template<typename Device>
+template<typename C>
+void SdoServer<Device>::initiateUpload(Address address, C&& cb)
+{
+    if (const auto error = beginUpload(address); error != SdoErrorCode::NoError) {
+        abortTransfer(address, error, std::forward<C>(cb));
+        return;
+    }
+    // read one byte more than fits into the response to detect oversized domains
+    std::array<uint8_t, 5> data{};
+    const std::size_t size = readUpload(0, data);
+    if (size > 0 && size <= 4) {
+        std::forward<C>(cb)(detail::uploadResponse(nodeId_, address, std::span{data}.first(size)));
+        return;
+    }
+
+    state_ = State::SegmentedUpload;
+    const uint8_t sizeFlag = transfer_.sizeIndicated ? detail::sizeIndicated : 0;
+    auto response = detail::sdoResponse(nodeId_, detail::commandUpload | sizeFlag, address);
+    if (transfer_.sizeIndicated) {
+        const uint32_t objectSize = transfer_.size;
+        std::memcpy(&response.data[4], &objectSize, sizeof(objectSize));
+    }
+    std::forward<C>(cb)(response);
+}
+
+template<typename Device>
+template<typename C>
+void SdoServer<Device>::processUploadSegment(const modm::can::Message& request, C&& cb)
+{
+    const uint8_t command = request.data[0];
+    if ((command & ~detail::toggleBit) != detail::commandUploadSegment) {
+        abortTransfer(transfer_.address, SdoErrorCode::InvalidCommandSpecifier, std::forward<C>(cb));
+        return;
+    }
+    const bool toggle = command & detail::toggleBit;
+    if (toggle != transfer_.toggle) {
+        abortTransfer(transfer_.address, SdoErrorCode::ToggleBitNotAlternated, std::forward<C>(cb));
+        return;
+    }
+
+    // read one byte ahead to detect the last segment
+    std::array<uint8_t, 8> data{};
+    const std::size_t readSize = readUpload(transfer_.offset, data);
+    const bool last = (readSize <= 7);
+    const auto segment = std::span{data}.first(std::min<std::size_t>(readSize, 7));
 
-    const uint16_t canId = 0x600 | nodeId_;
-
-    if (request.identifier == canId && request.getLength() == 8) {
-        const Address address {
-            .index = uint16_t((request.data[2] << 8) | request.data[1]),
-            .subindex = request.data[3]
-        };
-        // TODO: clean-up, refactor into functions
-        if ((request.data[0] & commandUploadMask) == commandUpload) {
-            auto result = Device::read(address);
-            if (const SdoErrorCode* error = std::get_if<SdoErrorCode>(&result); error) {
-                std::forward<C>(cb)(detail::transferAbort(nodeId_, address, *error));
-            } else {
-                // std::get_if can't return nullptr
-                // there are only two possible types: SdoErrorCode and Value
-                const Value& value = *std::get_if<Value>(&result);
-                if (valueSupportsExpediteTransfer(value)) {
-                    std::forward<C>(cb)(detail::uploadResponse(nodeId_, address, value));
-                } else {
-                    std::forward<C>(cb)(detail::transferAbort(nodeId_, address, SdoErrorCode::UnsupportedAccess));
-                }
+    const uint8_t unusedBytes = 7 - segment.size();
+    auto response = detail::sdoResponse(nodeId_, (toggle ? detail::toggleBit : 0) | (unusedBytes << 1)
+                                                 | (last ? detail::noMoreSegments : 0));
+    std::copy(segment.begin(), segment.end(), &response.data[1]);
+
+    transfer_.offset += segment.size();
+    transfer_.toggle = !toggle;
+    if (last) {
+        state_ = State::Idle;
+    }
+    std::forward<C>(cb)(response);
+}
+
+template<typename Device>
+template<typename C>
+void SdoServer<Device>::initiateExpeditedDownload(Address address, const modm::can::Message& request, C&& cb)
+{
+    const uint8_t type = request.data[0];
+    const bool sizeIndicated = type & detail::sizeIndicated;
+    const std::size_t size = sizeIndicated ? (4 - ((type & 0b1100) >> 2)) : 4;
+
+    auto error = beginDownload(address, sizeIndicated, size);
+    if (error == SdoErrorCode::NoError) {
+        error = writeDownload(std::span<const uint8_t>{&request.data[4], size}, true);
+    }
+    if (error == SdoErrorCode::NoError) {
+        std::forward<C>(cb)(detail::downloadResponse(nodeId_, address));
+    } else {
+        abortTransfer(address, error, std::forward<C>(cb));
+    }
+}
+
+template<typename Device>
+template<typename C>
+void SdoServer<Device>::initiateSegmentedDownload(Address address, const modm::can::Message& request, C&& cb)
+{
+    const bool sizeIndicated = request.data[0] & detail::sizeIndicated;
+    const std::size_t size = sizeIndicated ? detail::readUInt32(&request.data[4]) : 0;
+
+    if (const auto error = beginDownload(address, sizeIndicated, size); error != SdoErrorCode::NoError) {
+        abortTransfer(address, error, std::forward<C>(cb));
+        return;
+    }
+    state_ = State::SegmentedDownload;
+    std::forward<C>(cb)(detail::downloadResponse(nodeId_, address));
+}
+
+template<typename Device>
+template<typename C>
+void SdoServer<Device>::processDownloadSegment(const modm::can::Message& request, C&& cb)
+{
+    const uint8_t command = request.data[0];
+    if ((command & detail::commandSpecifierMask) != detail::commandDownloadSegment) {
+        abortTransfer(transfer_.address, SdoErrorCode::InvalidCommandSpecifier, std::forward<C>(cb));
+        return;
+    }
+    const bool toggle = command & detail::toggleBit;
+    if (toggle != transfer_.toggle) {
+        abortTransfer(transfer_.address, SdoErrorCode::ToggleBitNotAlternated, std::forward<C>(cb));
+        return;
+    }
+    const uint8_t unusedBytes = (command >> 1) & 0b111;
+    const bool complete = command & detail::noMoreSegments;
+    const auto data = std::span<const uint8_t>{&request.data[1], std::size_t(7 - unusedBytes)};
+
+    if (transfer_.sizeIndicated) {
+        const std::size_t received = transfer_.offset + data.size();
+        if (received > transfer_.size) {
+            abortTransfer(transfer_.address, SdoErrorCode::LengthTooHigh, std::forward<C>(cb));
+            return;
+        }
+        if (complete && received < transfer_.size) {
+            abortTransfer(transfer_.address, SdoErrorCode::LengthTooLow, std::forward<C>(cb));
+            return;
+        }
+    }
+    if (const auto error = writeDownload(data, complete); error != SdoErrorCode::NoError) {
+        abortTransfer(transfer_.address, error, std::forward<C>(cb));
+        return;
+    }
+
+    transfer_.toggle = !toggle;
+    if (complete) {
+        state_ = State::Idle;
+    }
+    std::forward<C>(cb)(detail::sdoResponse(nodeId_, 0b001'0'00'0'0 | (toggle ? detail::toggleBit : 0)));
+}
+
+template<typename Device>
+template<typename C>
+void SdoServer<Device>::initiateBlockDownload(Address address, const modm::can::Message& request, C&& cb)
+{
+    const uint8_t command = request.data[0];
+    const bool sizeIndicated = command & detail::blockSizeIndicated;
+    const std::size_t size = sizeIndicated ? detail::readUInt32(&request.data[4]) : 0;
+
+    if (const auto error = beginDownload(address, sizeIndicated, size); error != SdoErrorCode::NoError) {
+        abortTransfer(address, error, std::forward<C>(cb));
+        return;
+    }
+    transfer_.crcEnabled = command & detail::blockCrcSupported;
+    transfer_.blockSize = blockSize_;
+    state_ = State::BlockDownload;
+
+    auto response = detail::sdoResponse(nodeId_, 0b101'00'1'00, address);
+    response.data[4] = transfer_.blockSize;
+    std::forward<C>(cb)(response);
+}
+
+template<typename Device>
+template<typename C>
+void SdoServer<Device>::processBlockDownloadSegment(const modm::can::Message& request, C&& cb)
+{
+    const uint8_t sequence = request.data[0] & 0x7F;
+    const bool last = request.data[0] & detail::blockLastSegment;
+    if (sequence == 0) {
+        abortTransfer(transfer_.address, SdoErrorCode::InvalidSequenceNumber, std::forward<C>(cb));
+        return;
+    }
+
+    // segments after a lost one are ignored until the client repeats them
+    if (sequence == transfer_.sequence + 1 && !transfer_.lastSegmentReceived) {
+        if (transfer_.segmentPending) {
+            const auto error = writeDownload(transfer_.pendingSegment, false);
+            if (error != SdoErrorCode::NoError) {
+                abortTransfer(transfer_.address, error, std::forward<C>(cb));
+                return;
             }
-        } else if ((request.data[0] & commandDownloadMask) == commandExpediteDownload) {
-            const uint8_t type = request.data[0];
-            const int_fast8_t size = (type & sizeIndicated) ? (4-((type & 0b1100) >> 2)) : -1;
-            const SdoErrorCode error = Device::write(address, std::span<const uint8_t>{&request.data[4], 4}, size);
-            if (error == SdoErrorCode::NoError) {
-                std::forward<C>(cb)(detail::downloadResponse(nodeId_, address));
-            } else {
-                std::forward<C>(cb)(detail::transferAbort(nodeId_, address, error));
+        }
+        std::copy(&request.data[1], &request.data[8], transfer_.pendingSegment.begin());
+        transfer_.segmentPending = true;
+        transfer_.lastSegmentReceived = last;
+        transfer_.sequence = sequence;
+    }
+
+    if (last || sequence >= transfer_.blockSize) {
+        auto response = detail::sdoResponse(nodeId_, 0b101'000'10);
+        response.data[1] = transfer_.sequence;
+        response.data[2] = transfer_.blockSize;
+        transfer_.sequence = 0;
+        if (transfer_.lastSegmentReceived) {
+            state_ = State::BlockDownloadEnd;
+        }
+        std::forward<C>(cb)(response);
+    }
+}
+
+template<typename Device>
+template<typename C>
+void SdoServer<Device>::processBlockDownloadEnd(const modm::can::Message& request, C&& cb)
+{
+    const uint8_t command = request.data[0];
+    if ((command & detail::blockDownloadSubcommand) != detail::blockDownloadEnd) {
+        abortTransfer(transfer_.address, SdoErrorCode::InvalidCommandSpecifier, std::forward<C>(cb));
+        return;
+    }
+    const uint8_t unusedBytes = (command >> 2) & 0b111;
+    const auto data = std::span<const uint8_t>{transfer_.pendingSegment}.first(7 - unusedBytes);
+
+    if (transfer_.crcEnabled) {
+        const uint16_t crc = request.data[1] | (request.data[2] << 8);
+        if (detail::sdoCrc(transfer_.crc, data) != crc) {
+            abortTransfer(transfer_.address, SdoErrorCode::CrcError, std::forward<C>(cb));
+            return;
+        }
+    }
+    if (transfer_.sizeIndicated && (transfer_.offset + data.size() != transfer_.size)) {
+        const auto error = (transfer_.offset + data.size() > transfer_.size) ?
+            SdoErrorCode::LengthTooHigh : SdoErrorCode::LengthTooLow;
+        abortTransfer(transfer_.address, error, std::forward<C>(cb));
+        return;
+    }
+
+    if (const auto error = writeDownload(data, true); error != SdoErrorCode::NoError) {
+        abortTransfer(transfer_.address, error, std::forward<C>(cb));
+        return;
+    }
+    state_ = State::Idle;
+    std::forward<C>(cb)(detail::sdoResponse(nodeId_, 0b101'000'01));
+}
+
+template<typename Device>
+template<typename C>
+void SdoServer<Device>::initiateBlockUpload(Address address, const modm::can::Message& request, C&& cb)
+{
+    const uint8_t command = request.data[0];
+    const uint8_t blockSize = request.data[4];
+    if (blockSize == 0 || blockSize > MaxBlockSize) {
+        abortTransfer(address, SdoErrorCode::InvalidBlockSize, std::forward<C>(cb));
+        return;
+    }
+    if (const auto error = beginUpload(address); error != SdoErrorCode::NoError) {
+        abortTransfer(address, error, std::forward<C>(cb));
+        return;
+    }
+    transfer_.crcEnabled = command & detail::blockCrcSupported;
+    transfer_.blockSize = blockSize;
+    state_ = State::BlockUploadStart;
+
+    const uint8_t sizeFlag = transfer_.sizeIndicated ? detail::blockSizeIndicated : 0;
+    auto response = detail::sdoResponse(nodeId_, 0b110'00'1'0'0 | sizeFlag, address);
+    const uint32_t size = transfer_.size;
+    std::memcpy(&response.data[4], &size, sizeof(size));
+    std::forward<C>(cb)(response);
+}
+
+template<typename Device>
+template<typename C>
+void SdoServer<Device>::processBlockUploadAck(const modm::can::Message& request, C&& cb)
+{
+    if (request.data[0] != detail::blockUploadAck) {
+        abortTransfer(transfer_.address, SdoErrorCode::InvalidCommandSpecifier, std::forward<C>(cb));
+        return;
+    }
+    const uint8_t acknowledged = request.data[1];
+    const uint8_t blockSize = request.data[2];
+    if (acknowledged > transfer_.sequence) {
+        abortTransfer(transfer_.address, SdoErrorCode::InvalidSequenceNumber, std::forward<C>(cb));
+        return;
+    }
+    if (blockSize == 0 || blockSize > MaxBlockSize) {
+        abortTransfer(transfer_.address, SdoErrorCode::InvalidBlockSize, std::forward<C>(cb));
+        return;
+    }
+    transfer_.blockSize = blockSize;
+
+    if (acknowledged == transfer_.sequence) {
+        transfer_.offset = transfer_.blockEnd;
+        if (transfer_.lastSegmentSent) {
+            state_ = State::BlockUploadEnd;
+            const uint8_t unusedBytes = 7 - transfer_.lastSegmentSize;
+            auto response = detail::sdoResponse(nodeId_, 0b110'000'01 | (unusedBytes << 2));
+            response.data[1] = transfer_.crc & 0xFF;
+            response.data[2] = transfer_.crc >> 8;
+            std::forward<C>(cb)(response);
+            return;
+        }
+    } else {
+        // repeat lost segments, recalculate checksum of acknowledged data
+        transfer_.offset = transfer_.blockOffset;
+        transfer_.crc = transfer_.blockCrc;
+        const std::size_t end = transfer_.blockOffset + acknowledged * 7;
+        std::array<uint8_t, 7> data{};
+        while (transfer_.offset < end) {
+            const auto segment = std::span{data}.first(std::min<std::size_t>(end - transfer_.offset, 7));
+            const std::size_t size = readUpload(transfer_.offset, segment);
+            if (size < segment.size()) {
+                // acknowledged data can't be read again, e.g. a domain changed its size
+                abortTransfer(transfer_.address, SdoErrorCode::GeneralError, std::forward<C>(cb));
+                return;
             }
-        } else {
-            std::forward<C>(cb)(detail::transferAbort(nodeId_, address, SdoErrorCode::UnsupportedAccess));
+            transfer_.crc = detail::sdoCrc(transfer_.crc, segment);
+            transfer_.offset += size;
+        }
+    }
+    sendBlock(std::forward<C>(cb));
+}
+
+template<typename Device>
+template<typename C>
+void SdoServer<Device>::sendBlock(C&& cb)
+{
+    transfer_.blockOffset = transfer_.offset;
+    transfer_.blockCrc = transfer_.crc;
+    transfer_.sequence = 0;
+    transfer_.lastSegmentSent = false;
+
+    std::size_t position = transfer_.offset;
+    while (transfer_.sequence < transfer_.blockSize) {
+        // read one byte ahead to detect the last segment
+        std::array<uint8_t, 8> data{};
+        const std::size_t readSize = readUpload(position, data);
+        const bool last = (readSize <= 7);
+        const auto segment = std::span{data}.first(std::min<std::size_t>(readSize, 7));
+
+        ++transfer_.sequence;
+        modm::can::Message message{uint32_t(0x580 | nodeId_), 8};
+        message.setExtended(false);
+        message.data[0] = transfer_.sequence | (last ? detail::blockLastSegment : 0);
+        std::copy(segment.begin(), segment.end(), &message.data[1]);
+
+        if (transfer_.crcEnabled) {
+            transfer_.crc = detail::sdoCrc(transfer_.crc, segment);
+        }
+        position += segment.size();
+        std::forward<C>(cb)(message);
+
+        if (last) {
+            transfer_.lastSegmentSent = true;
+            transfer_.lastSegmentSize = segment.size();
+            break;
+        }
+    }
+    transfer_.blockEnd = position;
+}
+
+template<typename Device>
+template<typename C>
+void SdoServer<Device>::abortTransfer(Address address, SdoErrorCode error, C&& cb)
+{
+    cancelTransfer();
+    std::forward<C>(cb)(detail::transferAbort(nodeId_, address, error));
+}
+
+template<typename Device>
+void SdoServer<Device>::cancelTransfer()
+{
+    const bool downloading = (state_ == State::SegmentedDownload) ||
+        (state_ == State::BlockDownload) || (state_ == State::BlockDownloadEnd);
+    if (downloading && transfer_.domainWrite) {
+        // an empty chunk without complete flag signals the abort, see DomainWriteFunction
+        transfer_.domainWrite(device_, transfer_.offset, std::span<const uint8_t>{}, false);
+    }
+    state_ = State::Idle;
+}
+
+template<typename Device>
+SdoErrorCode SdoServer<Device>::beginUpload(Address address)
+{
+    const auto entry = ObjectDictionary::map.lookup(address);
+    if (!entry) {
+        return SdoErrorCode::ObjectDoesNotExist;
+    }
+    transfer_ = Transfer{.address = address};
+
+    if (entry->dataType == DataType::Domain) {
+        if (!entry->isReadable()) {
+            return SdoErrorCode::ReadOfWriteOnlyObject;
+        }
+        const auto handler = Device::accessHandlers.lookupReadHandler(address);
+        if (!handler || !std::holds_alternative<DomainReadHandler>(*handler)) {
+            return SdoErrorCode::UnsupportedAccess;
+        }
+        transfer_.domainRead = std::get<DomainReadHandler>(*handler);
+        return SdoErrorCode::NoError;
+    }
+
+    if (const auto error = device_->readInto(address, transfer_.buffer); error != SdoErrorCode::NoError) {
+        return error;
+    }
+    transfer_.size = getDataTypeSize(entry->dataType);
+    transfer_.sizeIndicated = true;
+    return SdoErrorCode::NoError;
+}
+
+template<typename Device>
+std::size_t SdoServer<Device>::readUpload(std::size_t offset, std::span<uint8_t> data)
+{
+    if (transfer_.domainRead) {
+        return transfer_.domainRead(device_, offset, data);
+    }
+    if (offset >= transfer_.size) {
+        return 0;
+    }
+    const std::size_t size = std::min(data.size(), transfer_.size - offset);
+    std::copy_n(&transfer_.buffer[offset], size, data.begin());
+    return size;
+}
+
+template<typename Device>
+SdoErrorCode SdoServer<Device>::beginDownload(Address address, bool sizeIndicated, std::size_t size)
+{
+    const auto entry = ObjectDictionary::map.lookup(address);
+    if (!entry) {
+        return SdoErrorCode::ObjectDoesNotExist;
+    }
+    if (!entry->isWritable()) {
+        return SdoErrorCode::WriteOfReadOnlyObject;
+    }
+    transfer_ = Transfer{.address = address, .sizeIndicated = sizeIndicated, .size = size};
+
+    if (entry->dataType == DataType::Domain) {
+        const auto handler = Device::accessHandlers.lookupWriteHandler(address);
+        if (!handler || !std::holds_alternative<DomainWriteHandler>(*handler)) {
+            return SdoErrorCode::UnsupportedAccess;
         }
+        transfer_.domainWrite = std::get<DomainWriteHandler>(*handler);
+        return SdoErrorCode::NoError;
+    }
+
+    const std::size_t objectSize = getDataTypeSize(entry->dataType);
+    if (sizeIndicated && size > objectSize) {
+        return SdoErrorCode::LengthTooHigh;
     }
+    if (sizeIndicated && size < objectSize) {
+        return SdoErrorCode::LengthTooLow;
+    }
+    return SdoErrorCode::NoError;
+}
+
+template<typename Device>
+SdoErrorCode SdoServer<Device>::writeDownload(std::span<const uint8_t> data, bool complete)
+{
+    if (transfer_.crcEnabled) {
+        transfer_.crc = detail::sdoCrc(transfer_.crc, data);
+    }
+
+    if (transfer_.domainWrite) {
+        if (data.empty() && !complete) {
+            // reserved to signal an abort to the handler
+            return SdoErrorCode::NoError;
+        }
+        const auto error = transfer_.domainWrite(device_, transfer_.offset, data, complete);
+        transfer_.offset += data.size();
+        return error;
+    }
+
+    if (transfer_.offset + data.size() > transfer_.buffer.size()) {
+        return SdoErrorCode::LengthTooHigh;
+    }
+    std::copy(data.begin(), data.end(), &transfer_.buffer[transfer_.offset]);
+    transfer_.offset += data.size();
+    if (!complete) {
+        return SdoErrorCode::NoError;
+    }
+    const int8_t size = transfer_.sizeIndicated ? int8_t(transfer_.offset) : -1;
+    return device_->writeFrom(transfer_.address, std::span<const uint8_t>{transfer_.buffer}.first(transfer_.offset), size);
 }
 
 template<typename Device>
@@ -65,44 +640,83 @@ void SdoServer<Device>::setNodeId(uint8_t id)
     nodeId_ = id;
 }
 
-auto detail::uploadResponse(uint8_t nodeId, Address address, const Value& value)
+template<typename Device>
+SdoErrorCode SdoServer<Device>::setBlockSize(uint8_t segments)
+{
+    if (segments == 0 || segments > MaxBlockSize) {
+        return SdoErrorCode::InvalidBlockSize;
+    }
+    blockSize_ = segments;
+    return SdoErrorCode::NoError;
+}
+
+template<typename Device>
+uint8_t SdoServer<Device>::blockSize() const
+{
+    return blockSize_;
+}
+
+template<typename Device>
+void SdoServer<Device>::setTransferTimeout(modm::PreciseDuration timeout)
+{
+    transferTimeout_ = timeout;
+}
+
+template<typename Device>
+modm::PreciseDuration SdoServer<Device>::transferTimeout() const
+{
+    return transferTimeout_;
+}
+
+auto detail::sdoResponse(uint8_t nodeId, uint8_t command)
     -> modm::can::Message
 {
     modm::can::Message message{uint32_t(0x580 | nodeId), 8};
     message.setExtended(false);
-    const auto sizeFlags = (0b11 & (4 - getValueSize(value))) << 2;
-    message.data[0] = 0b010'0'00'1'1 | sizeFlags;
-    message.data[1] = address.index & 0xFF;
-    message.data[2] = (address.index & 0xFF'00) >> 8;
-    message.data[3] = address.subindex;
-    valueToBytes(value, &message.data[4]);
+    message.data[0] = command;
     return message;
 }
 
-auto detail::downloadResponse(uint8_t nodeId, Address address)
+auto detail::sdoResponse(uint8_t nodeId, uint8_t command, Address address)
     -> modm::can::Message
 {
-    modm::can::Message message{uint32_t(0x580 | nodeId), 8};
-    message.setExtended(false);
-    message.data[0] = 0b011'00000;
+    modm::can::Message message = sdoResponse(nodeId, command);
     message.data[1] = address.index & 0xFF;
     message.data[2] = (address.index & 0xFF'00) >> 8;
     message.data[3] = address.subindex;
     return message;
 }
 
+auto detail::uploadResponse(uint8_t nodeId, Address address, std::span<const uint8_t> data)
+    -> modm::can::Message
+{
+    const auto sizeFlags = (0b11 & (4 - data.size())) << 2;
+    modm::can::Message message = sdoResponse(nodeId, 0b010'0'00'1'1 | sizeFlags, address);
+    std::copy(data.begin(), data.end(), &message.data[4]);
+    return message;
+}
+
+auto detail::downloadResponse(uint8_t nodeId, Address address)
+    -> modm::can::Message
+{
+    return sdoResponse(nodeId, 0b011'00000, address);
+}
+
 auto detail::transferAbort(uint8_t nodeId, Address address, SdoErrorCode error)
     -> modm::can::Message
 {
-    modm::can::Message message{uint32_t(0x580 | nodeId), 8};
-    message.setExtended(false);
-    message.data[0] = 0b100'00000;
-    message.data[1] = address.index & 0xFF;
-    message.data[2] = (address.index & 0xFF'00) >> 8;
-    message.data[3] = address.subindex;
+    modm::can::Message message = sdoResponse(nodeId, 0b100'00000, address);
     static_assert(sizeof(SdoErrorCode) == 4);
     memcpy(&message.data[4], &error, sizeof(SdoErrorCode));
     return message;
 }
 
+uint16_t detail::sdoCrc(uint16_t crc, std::span<const uint8_t> data)
+{
+    for (const uint8_t byte : data) {
+        crc = (crc << 8) ^ sdoCrcTable[((crc >> 8) ^ byte) & 0xFF];
+    }
+    return crc;
+}
+
 }
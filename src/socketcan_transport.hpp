@@ -0,0 +1,99 @@
+#ifndef CANOPEN_SOCKETCAN_TRANSPORT_HPP
+#define CANOPEN_SOCKETCAN_TRANSPORT_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <array>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <linux/can.h>
+#include <linux/can/raw.h>
+#include <net/if.h>
+#include <sys/epoll.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <sys/timerfd.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <modm/architecture/interface/can_message.hpp>
+#include <modm/architecture/interface/clock.hpp>
+
+namespace modm_canopen
+{
+
+/// Linux SocketCAN transport for a CanopenNode
+///
+/// Waits for frames and PDO deadlines with epoll. Received frames are read in batches
+/// with recvmmsg(), all frames produced while processing them are sent with sendmmsg().
+/// Only identifiers consumed by the node pass the CAN_RAW_FILTER of the socket, the filter
+/// is updated when the node changes its consumed COB-IDs.
+template<typename Node>
+class SocketCanTransport
+{
+public:
+    /// Maximum number of frames received or sent per system call
+    static constexpr std::size_t BatchSize{64};
+
+    explicit SocketCanTransport(Node& node);
+    ~SocketCanTransport();
+
+    SocketCanTransport(const SocketCanTransport&) = delete;
+    SocketCanTransport& operator=(const SocketCanTransport&) = delete;
+
+    bool open(const char* interface);
+    void close();
+    bool isOpen() const;
+
+    /// Wait until frames are received, a PDO is due or the timeout expires, then process
+    /// all received frames and transmit the resulting messages
+    /// \param timeout maximum time to wait, rounded up to milliseconds
+    /// \return false on socket errors
+    bool poll(modm::PreciseDuration timeout = modm::PreciseDuration::max());
+
+    /// epoll file descriptor, readable on received frames and due PDOs
+    /// Can be added to an external event loop calling poll() with zero timeout.
+    int fileDescriptor() const { return epoll_; }
+
+    /// Number of transmit frames dropped because the socket was not ready to send
+    std::size_t droppedFrames() const { return droppedFrames_; }
+
+private:
+    /// Arm the timer for the next update() of the node
+    void armTimer(modm::PreciseDuration delay);
+    bool receive();
+    bool updateFilter();
+    void queue(const modm::can::Message& message);
+    void flush();
+
+    Node& node_;
+    int socket_{-1};
+    int epoll_{-1};
+    int timer_{-1};
+
+    std::array<can_filter, Node::MaxConsumedCanIdCount> filters_{};
+    uint32_t filterRevision_{};
+
+    std::array<can_frame, BatchSize> rxFrames_{};
+    std::array<iovec, BatchSize> rxVectors_{};
+    std::array<mmsghdr, BatchSize> rxHeaders_{};
+
+    std::array<can_frame, BatchSize> txFrames_{};
+    std::array<iovec, BatchSize> txVectors_{};
+    std::array<mmsghdr, BatchSize> txHeaders_{};
+    std::size_t txCount_{};
+    std::size_t droppedFrames_{};
+};
+
+namespace detail
+{
+    inline auto toMessage(const can_frame& frame) -> modm::can::Message;
+
+    inline auto toCanFrame(const modm::can::Message& message) -> can_frame;
+}
+
+}
+
+#include "socketcan_transport_impl.hpp"
+
+#endif // CANOPEN_SOCKETCAN_TRANSPORT_HPP
@@ -0,0 +1,238 @@
+#ifndef CANOPEN_SOCKETCAN_TRANSPORT_HPP
+#error "Do not include this file directly, include socketcan_transport.hpp instead!"
+#endif
+
+namespace modm_canopen
+{
+
+template<typename Node>
+SocketCanTransport<Node>::SocketCanTransport(Node& node)
+    : node_{node}
+{
+    for (std::size_t i = 0; i < BatchSize; ++i) {
+        rxVectors_[i] = iovec{&rxFrames_[i], sizeof(can_frame)};
+        rxHeaders_[i].msg_hdr.msg_iov = &rxVectors_[i];
+        rxHeaders_[i].msg_hdr.msg_iovlen = 1;
+
+        txVectors_[i] = iovec{&txFrames_[i], sizeof(can_frame)};
+        txHeaders_[i].msg_hdr.msg_iov = &txVectors_[i];
+        txHeaders_[i].msg_hdr.msg_iovlen = 1;
+    }
+}
+
+template<typename Node>
+SocketCanTransport<Node>::~SocketCanTransport()
+{
+    close();
+}
+
+template<typename Node>
+bool SocketCanTransport<Node>::open(const char* interface)
+{
+    close();
+
+    // the socket is blocking to throttle sendmmsg(), frames are received with MSG_DONTWAIT
+    socket_ = ::socket(PF_CAN, SOCK_RAW | SOCK_CLOEXEC, CAN_RAW);
+    if (socket_ < 0) {
+        return false;
+    }
+
+    ifreq request{};
+    std::strncpy(request.ifr_name, interface, IFNAMSIZ - 1);
+    if (::ioctl(socket_, SIOCGIFINDEX, &request) < 0) {
+        close();
+        return false;
+    }
+
+    sockaddr_can address{};
+    address.can_family = AF_CAN;
+    address.can_ifindex = request.ifr_ifindex;
+    if (!updateFilter() || ::bind(socket_, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0) {
+        close();
+        return false;
+    }
+
+    epoll_ = ::epoll_create1(EPOLL_CLOEXEC);
+    timer_ = ::timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (epoll_ < 0 || timer_ < 0) {
+        close();
+        return false;
+    }
+
+    for (const int fd : {socket_, timer_}) {
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.fd = fd;
+        if (::epoll_ctl(epoll_, EPOLL_CTL_ADD, fd, &event) < 0) {
+            close();
+            return false;
+        }
+    }
+
+    txCount_ = 0;
+    armTimer(modm::PreciseDuration{});
+    return true;
+}
+
+template<typename Node>
+void SocketCanTransport<Node>::close()
+{
+    for (int* fd : {&timer_, &epoll_, &socket_}) {
+        if (*fd >= 0) {
+            ::close(*fd);
+            *fd = -1;
+        }
+    }
+}
+
+template<typename Node>
+bool SocketCanTransport<Node>::isOpen() const
+{
+    return socket_ >= 0;
+}
+
+template<typename Node>
+bool SocketCanTransport<Node>::poll(modm::PreciseDuration timeout)
+{
+    if (!isOpen()) {
+        return false;
+    }
+    if (filterRevision_ != node_.consumedCanIdRevision() && !updateFilter()) {
+        return false;
+    }
+
+    int timeoutMs = -1;
+    if (timeout != modm::PreciseDuration::max()) {
+        timeoutMs = int(std::chrono::ceil<std::chrono::milliseconds>(timeout).count());
+    }
+    std::array<epoll_event, 2> events{};
+    const int count = ::epoll_wait(epoll_, events.data(), events.size(), timeoutMs);
+    if (count < 0 && errno != EINTR) {
+        return false;
+    }
+
+    for (int i = 0; i < count; ++i) {
+        if (events[i].data.fd == socket_) {
+            if (!receive()) {
+                return false;
+            }
+        } else {
+            uint64_t expirations;
+            [[maybe_unused]] const auto result = ::read(timer_, &expirations, sizeof(expirations));
+        }
+    }
+
+    const auto delay = node_.update([this](const modm::can::Message& message) { queue(message); });
+    flush();
+    armTimer(delay);
+    return true;
+}
+
+template<typename Node>
+void SocketCanTransport<Node>::armTimer(modm::PreciseDuration delay)
+{
+    // a zero timer value disarms the timer
+    itimerspec value{};
+    if (delay.count() == 0) {
+        value.it_value.tv_nsec = 1;
+    } else if (delay != modm::PreciseDuration::max()) {
+        const auto us = delay.count();
+        value.it_value.tv_sec = us / 1'000'000;
+        value.it_value.tv_nsec = (us % 1'000'000) * 1'000;
+    }
+    ::timerfd_settime(timer_, 0, &value, nullptr);
+}
+
+template<typename Node>
+bool SocketCanTransport<Node>::receive()
+{
+    const auto callback = [this](const modm::can::Message& message) { queue(message); };
+    while (true) {
+        const int count = ::recvmmsg(socket_, rxHeaders_.data(), BatchSize, MSG_DONTWAIT, nullptr);
+        if (count < 0) {
+            return (errno == EAGAIN) || (errno == EINTR);
+        }
+        for (int i = 0; i < count; ++i) {
+            if (rxHeaders_[i].msg_len == sizeof(can_frame)) {
+                node_.processMessage(detail::toMessage(rxFrames_[i]), callback);
+            }
+        }
+        if (std::size_t(count) < BatchSize) {
+            return true;
+        }
+    }
+}
+
+template<typename Node>
+bool SocketCanTransport<Node>::updateFilter()
+{
+    filterRevision_ = node_.consumedCanIdRevision();
+    std::size_t count = 0;
+    node_.forEachConsumedCanId([this, &count](uint32_t canId) {
+        // standard frames with matching identifier, data and remote frames
+        filters_[count++] = can_filter{canId, CAN_EFF_FLAG | CAN_SFF_MASK};
+    });
+    if (count > CAN_RAW_FILTER_MAX) {
+        // receive all frames, processMessage() drops the unused ones
+        filters_[0] = can_filter{0, 0};
+        count = 1;
+    }
+    return ::setsockopt(socket_, SOL_CAN_RAW, CAN_RAW_FILTER,
+                        filters_.data(), count * sizeof(can_filter)) == 0;
+}
+
+template<typename Node>
+void SocketCanTransport<Node>::queue(const modm::can::Message& message)
+{
+    if (txCount_ == BatchSize) {
+        flush();
+    }
+    txFrames_[txCount_++] = detail::toCanFrame(message);
+}
+
+template<typename Node>
+void SocketCanTransport<Node>::flush()
+{
+    std::size_t sent = 0;
+    while (sent < txCount_) {
+        const int count = ::sendmmsg(socket_, &txHeaders_[sent], txCount_ - sent, 0);
+        if (count < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            // ENOBUFS: transmit queue of the interface is full
+            droppedFrames_ += txCount_ - sent;
+            break;
+        }
+        sent += count;
+    }
+    txCount_ = 0;
+}
+
+auto detail::toMessage(const can_frame& frame) -> modm::can::Message
+{
+    const bool extended = frame.can_id & CAN_EFF_FLAG;
+    const uint32_t identifier = frame.can_id & (extended ? CAN_EFF_MASK : CAN_SFF_MASK);
+    modm::can::Message message{identifier, std::min<uint8_t>(frame.can_dlc, CAN_MAX_DLEN)};
+    message.setExtended(extended);
+    message.setRemoteTransmitRequest(frame.can_id & CAN_RTR_FLAG);
+    std::memcpy(message.data, frame.data, message.getLength());
+    return message;
+}
+
+auto detail::toCanFrame(const modm::can::Message& message) -> can_frame
+{
+    can_frame frame{};
+    frame.can_id = message.getIdentifier();
+    if (message.isExtended()) {
+        frame.can_id |= CAN_EFF_FLAG;
+    }
+    if (message.isRemoteTransmitRequest()) {
+        frame.can_id |= CAN_RTR_FLAG;
+    }
+    frame.can_dlc = std::min<uint8_t>(message.getLength(), CAN_MAX_DLEN);
+    std::memcpy(frame.data, message.data, frame.can_dlc);
+    return frame;
+}
+
+}
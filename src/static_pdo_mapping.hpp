@@ -0,0 +1,60 @@
+#ifndef CANOPEN_STATIC_PDO_MAPPING_HPP
+#define CANOPEN_STATIC_PDO_MAPPING_HPP
+
+#include <array>
+#include <cstdint>
+#include <utility>
+#include <variant>
+#include "handler_map.hpp"
+#include "pdo_common.hpp"
+
+namespace modm_canopen
+{
+
+/// PDO mapping fixed at compile time
+/// pack() and unpack() call the handlers registered in the handler map directly with fixed
+/// offsets instead of interpreting the mapping for every message. Mappings are validated
+/// at compile time.
+template<typename OD, const HandlerMap<OD>& handlers, PdoMapping... mappings>
+class StaticPdoMapping
+{
+public:
+    static constexpr std::array<PdoMapping, sizeof...(mappings)> Mappings{mappings...};
+    static constexpr uint8_t PayloadSize = (0 + ... + mappings.bitLength) / 8;
+
+    static_assert(sizeof...(mappings) <= 8, "Too many mapped objects");
+    static_assert((0 + ... + mappings.bitLength) <= 8*8, "Mappings exceed PDO length");
+
+    /// Write mapped objects of a transmit PDO to data
+    static void pack(void* context, uint8_t* data);
+
+    /// Write mapped objects of a receive PDO from data
+    /// \return bit mask of the mappings written successfully
+    static uint8_t unpack(void* context, const uint8_t* data);
+
+private:
+    static constexpr std::array<uint8_t, sizeof...(mappings)> Offsets = [] {
+        std::array<uint8_t, sizeof...(mappings)> offsets{};
+        uint8_t offset = 0;
+        for (std::size_t i = 0; i < offsets.size(); ++i) {
+            offsets[i] = offset;
+            offset += Mappings[i].bitLength / 8;
+        }
+        return offsets;
+    }();
+
+    template<PdoMapping mapping>
+    static constexpr bool validMapping(bool transmit);
+
+    template<PdoMapping mapping, uint8_t offset>
+    static void packValue(void* context, uint8_t* data);
+
+    template<PdoMapping mapping, uint8_t offset>
+    static bool unpackValue(void* context, const uint8_t* data);
+};
+
+}
+
+#include "static_pdo_mapping_impl.hpp"
+
+#endif // CANOPEN_STATIC_PDO_MAPPING_HPP
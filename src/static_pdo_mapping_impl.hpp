@@ -0,0 +1,64 @@
+#ifndef CANOPEN_STATIC_PDO_MAPPING_HPP
+#error "Do not include this file directly, include static_pdo_mapping.hpp instead!"
+#endif
+
+namespace modm_canopen
+{
+
+template<typename OD, const HandlerMap<OD>& handlers, PdoMapping... mappings>
+void StaticPdoMapping<OD, handlers, mappings...>::pack(void* context, uint8_t* data)
+{
+    [context, data]<std::size_t... i>(std::index_sequence<i...>) {
+        (packValue<Mappings[i], Offsets[i]>(context, data), ...);
+    }(std::make_index_sequence<sizeof...(mappings)>{});
+}
+
+template<typename OD, const HandlerMap<OD>& handlers, PdoMapping... mappings>
+uint8_t StaticPdoMapping<OD, handlers, mappings...>::unpack(void* context, const uint8_t* data)
+{
+    return [context, data]<std::size_t... i>(std::index_sequence<i...>) {
+        return uint8_t((0 | ... | (unpackValue<Mappings[i], Offsets[i]>(context, data) << i)));
+    }(std::make_index_sequence<sizeof...(mappings)>{});
+}
+
+template<typename OD, const HandlerMap<OD>& handlers, PdoMapping... mappings>
+template<PdoMapping mapping>
+constexpr bool StaticPdoMapping<OD, handlers, mappings...>::validMapping(bool transmit)
+{
+    const auto entry = OD::map.lookup(mapping.address);
+    return entry && (transmit ? entry->isTransmitPdoMappable() : entry->isReceivePdoMappable())
+        && (getDataTypeSize(entry->dataType) * 8 == mapping.bitLength);
+}
+
+template<typename OD, const HandlerMap<OD>& handlers, PdoMapping... mappings>
+template<PdoMapping mapping, uint8_t offset>
+void StaticPdoMapping<OD, handlers, mappings...>::packValue(void* context, uint8_t* data)
+{
+    constexpr bool valid = validMapping<mapping>(true);
+    static_assert(valid, "Invalid static transmit PDO mapping");
+
+    // if constexpr prevents ugly compiler output when assertion triggers
+    if constexpr (valid) {
+        using T = std::variant_alternative_t<std::size_t(OD::map.lookup(mapping.address)->dataType), Value>;
+        constexpr auto handler = std::get<ReadHandlerFunction<T>>(*handlers.lookupReadHandler(mapping.address));
+        detail::storeLittleEndian(handler(context), data + offset);
+    }
+}
+
+template<typename OD, const HandlerMap<OD>& handlers, PdoMapping... mappings>
+template<PdoMapping mapping, uint8_t offset>
+bool StaticPdoMapping<OD, handlers, mappings...>::unpackValue(void* context, const uint8_t* data)
+{
+    constexpr bool valid = validMapping<mapping>(false);
+    static_assert(valid, "Invalid static receive PDO mapping");
+
+    if constexpr (valid) {
+        using T = std::variant_alternative_t<std::size_t(OD::map.lookup(mapping.address)->dataType), Value>;
+        constexpr auto handler = std::get<WriteHandlerFunction<T>>(*handlers.lookupWriteHandler(mapping.address));
+        return handler(context, detail::loadLittleEndian<T>(data + offset)) == SdoErrorCode::NoError;
+    } else {
+        return false;
+    }
+}
+
+}
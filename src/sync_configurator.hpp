@@ -0,0 +1,80 @@
+#ifndef CANOPEN_SYNC_CONFIGURATOR_HPP
+#define CANOPEN_SYNC_CONFIGURATOR_HPP
+
+#include <cstdint>
+#include "object_dictionary.hpp"
+
+namespace modm_canopen
+{
+
+/// Registers the optional SYNC consumer objects 0x1005, 0x1007 and 0x1019
+template<typename Device>
+class SyncConfigurator
+{
+public:
+    constexpr void registerHandlers(Device::Map& map)
+    {
+        using OD = Device::ObjectDictionary;
+
+        // COB-ID SYNC
+        if constexpr (hasEntry<OD>(Address{0x1005, 0})) {
+            map.template setReadHandler<Address{0x1005, 0}>(
+                +[](void* context) -> uint32_t { return static_cast<Device*>(context)->syncCanId_; });
+
+            map.template setWriteHandler<Address{0x1005, 0}>(
+                +[](void* context, uint32_t cobId) {
+                    return setSyncCobId(*static_cast<Device*>(context), cobId);
+                });
+        }
+
+        // synchronous window length in microseconds, 0 to disable
+        if constexpr (hasEntry<OD>(Address{0x1007, 0})) {
+            map.template setReadHandler<Address{0x1007, 0}>(
+                +[](void* context) -> uint32_t { return static_cast<Device*>(context)->syncWindow_.count(); });
+
+            map.template setWriteHandler<Address{0x1007, 0}>(
+                +[](void* context, uint32_t window_us) {
+                    static_cast<Device*>(context)->syncWindow_ = std::chrono::microseconds(window_us);
+                    return SdoErrorCode::NoError;
+                });
+        }
+
+        // synchronous counter overflow value, 0 if SYNC messages have no counter
+        if constexpr (hasEntry<OD>(Address{0x1019, 0})) {
+            map.template setReadHandler<Address{0x1019, 0}>(
+                +[](void* context) -> uint8_t { return static_cast<Device*>(context)->syncCounterOverflow_; });
+
+            map.template setWriteHandler<Address{0x1019, 0}>(
+                +[](void* context, uint8_t overflow) {
+                    return setSyncCounterOverflow(*static_cast<Device*>(context), overflow);
+                });
+        }
+    }
+
+private:
+    static SdoErrorCode setSyncCobId(Device& device, uint32_t cobId)
+    {
+        const bool producer = cobId & (1u << 30);
+        const bool extended = cobId & (1u << 29);
+        // only SYNC consumer with 11-bit identifier supported
+        if (producer || extended || (cobId & 0x1FFF'F800)) {
+            return SdoErrorCode::InvalidValue;
+        }
+        device.syncCanId_ = cobId & 0x7FF;
+        device.updateDispatchTable();
+        return SdoErrorCode::NoError;
+    }
+
+    static SdoErrorCode setSyncCounterOverflow(Device& device, uint8_t overflow)
+    {
+        if (overflow == 1 || overflow > 240) {
+            return SdoErrorCode::InvalidValue;
+        }
+        device.syncCounterOverflow_ = overflow;
+        return SdoErrorCode::NoError;
+    }
+};
+
+}
+
+#endif // CANOPEN_SYNC_CONFIGURATOR_HPP
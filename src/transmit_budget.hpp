@@ -0,0 +1,129 @@
+#ifndef CANOPEN_TRANSMIT_BUDGET_HPP
+#define CANOPEN_TRANSMIT_BUDGET_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <modm/architecture/interface/can_message.hpp>
+#include <modm/processing/timer/timestamp.hpp>
+
+namespace modm_canopen
+{
+
+/// Worst-case length of a CAN frame in bits including stuff bits and interframe space
+constexpr uint32_t canFrameBits(uint8_t length, bool extended = false)
+{
+    const uint32_t stuffedBits = (extended ? 54u : 34u) + 8u * length;
+    return stuffedBits + 13u + (stuffedBits - 1u) / 4u;
+}
+
+/// Token bucket limiting the bus load caused by transmit PDOs
+///
+/// Tokens are counted in frames or in bits of worst-case frame length, the bucket holds
+/// up to burst frames and is refilled at a constant rate. A default constructed budget
+/// is unlimited.
+class TransmitBudget
+{
+public:
+    constexpr TransmitBudget() = default;
+
+    /// Allow framesPerSecond on average and bursts of up to burstFrames
+    static constexpr TransmitBudget frameRate(uint32_t framesPerSecond, uint32_t burstFrames = 1)
+    {
+        return TransmitBudget{framesPerSecond, 1, std::max<uint32_t>(burstFrames, 1), false};
+    }
+
+    /// Allow percent of the bus bit rate and bursts of up to burstFrames worst-case 8 byte frames
+    static constexpr TransmitBudget busLoad(uint32_t bitRate, uint8_t percent, uint32_t burstFrames = 1)
+    {
+        const auto rate = uint32_t(uint64_t(bitRate) * std::min<uint8_t>(percent, 100) / 100);
+        return TransmitBudget{rate, canFrameBits(8), std::max<uint32_t>(burstFrames, 1), true};
+    }
+
+    bool isLimited() const { return rate_ != 0; }
+
+    /// Tokens required to transmit message
+    uint32_t cost(uint8_t length, bool extended = false) const
+    {
+        return countBits_ ? canFrameBits(length, extended) : 1;
+    }
+
+    uint32_t cost(const modm::can::Message& message) const
+    {
+        return cost(message.getLength(), message.isExtended());
+    }
+
+    /// Add tokens for the time passed since the last refill
+    void refill(modm::PreciseTimestamp now)
+    {
+        const auto elapsed = uint64_t(std::chrono::duration_cast<std::chrono::microseconds>(
+            now - lastRefill_).count());
+        lastRefill_ = now;
+        // limit the elapsed time to the time required to fill the bucket to avoid overflows
+        const uint64_t fillTime = uint64_t(capacity_) / rate_ + 1;
+        tokens_ = std::min(capacity_, tokens_ + int64_t(std::min(elapsed, fillTime) * rate_));
+    }
+
+    /// Fill the bucket and restart refilling at now
+    void reset(modm::PreciseTimestamp now)
+    {
+        tokens_ = capacity_;
+        lastRefill_ = now;
+    }
+
+    /// Take tokens if available, the bucket must have been refilled before
+    bool tryConsume(uint32_t tokens)
+    {
+        const auto required = int64_t(tokens) * Scale;
+        if (tokens_ < required) {
+            return false;
+        }
+        tokens_ -= required;
+        return true;
+    }
+
+    /// Take tokens unconditionally, the bucket can go into debt
+    void consume(uint32_t tokens)
+    {
+        tokens_ -= int64_t(tokens) * Scale;
+    }
+
+    /// Time until tokens are available if nothing else is consumed
+    modm::PreciseDuration timeUntilAvailable(uint32_t tokens) const
+    {
+        const auto missing = int64_t(tokens) * Scale - tokens_;
+        if (missing <= 0) {
+            return modm::PreciseDuration{};
+        }
+        return std::chrono::microseconds((missing + rate_ - 1) / rate_);
+    }
+
+private:
+    /// Tokens are stored with microsecond resolution, refilling adds rate_ per microsecond
+    static constexpr int64_t Scale = 1'000'000;
+
+    constexpr TransmitBudget(uint32_t rate, uint32_t frameTokens, uint32_t burstFrames, bool countBits)
+        : rate_{rate}, capacity_{int64_t(frameTokens) * burstFrames * Scale}, tokens_{capacity_},
+          countBits_{countBits}
+    {}
+
+    uint32_t rate_{};
+    int64_t capacity_{};
+    int64_t tokens_{};
+    modm::PreciseTimestamp lastRefill_{};
+    bool countBits_{false};
+};
+
+/// Counters of the transmit scheduler, see CanopenNode::setTransmitBudget()
+struct TransmitStatistics
+{
+    /// Due event-driven PDO transmissions postponed because the budget was exhausted
+    /// A transmission waiting over several updates is counted once.
+    uint32_t deferred{};
+    /// Synchronous PDOs discarded because the synchronous window expired
+    uint32_t dropped{};
+};
+
+}
+
+#endif // CANOPEN_TRANSMIT_BUDGET_HPP
@@ -2,8 +2,15 @@
 #define CANOPEN_TRANSMIT_PDO_HPP
 
 #include "pdo_common.hpp"
+#include "handler_map.hpp"
+#include "constexpr_map.hpp"
+#include "process_image.hpp"
+#include <algorithm>
 #include <array>
+#include <atomic>
+#include <cstring>
 #include <optional>
+#include <span>
 #include <variant>
 #include <modm/architecture/interface/clock.hpp>
 #include <modm/architecture/interface/can_message.hpp>
@@ -24,21 +31,129 @@ struct SendOnEvent
         updated_ = true;
     }
 
-    bool send()
+    /// \return true if a value was updated or the event timer expired and the inhibit time passed
+    bool due(modm::PreciseTimestamp now) const
     {
-        const auto now = modm::chrono::micro_clock::now();
-        if (now > lastMessage_ + inhibitTime_) {
-            const bool timerEnabled = (eventTimeout_.count() != 0);
-            const bool timerExpired = now > (lastMessage_ + eventTimeout_);
-            if (updated_ || (timerEnabled && timerExpired)) {
-                lastMessage_ = now;
-                return true;
+        // compare elapsed durations instead of timestamps to handle clock overflow
+        const auto elapsed = now - lastMessage_;
+        return (elapsed >= inhibitTime_) && (updated_ || timerExpired(now));
+    }
+
+    bool timerExpired(modm::PreciseTimestamp now) const
+    {
+        return (eventTimeout_.count() != 0) && (now - lastMessage_) >= eventTimeout_;
+    }
+
+    void setSent(modm::PreciseTimestamp now)
+    {
+        lastMessage_ = now;
+    }
+
+    /// Time until send() will return true if no further event occurs
+    /// \return PreciseDuration::max() if no transmission is pending
+    modm::PreciseDuration timeUntilSend(modm::PreciseTimestamp now) const
+    {
+        modm::PreciseDuration delay;
+        if (updated_) {
+            delay = inhibitTime_;
+        } else if (eventTimeout_.count() != 0) {
+            delay = std::max(inhibitTime_, eventTimeout_);
+        } else {
+            return modm::PreciseDuration::max();
+        }
+        const auto elapsed = now - lastMessage_;
+        return (elapsed < delay) ? (delay - elapsed) : modm::PreciseDuration{};
+    }
+};
+
+struct SendOnSync
+{
+    uint8_t interval_{}; // 0: acyclic, n: every n-th SYNC
+    uint8_t startValue_{};
+    uint8_t remaining_{};
+    bool started_{false};
+
+    void reset()
+    {
+        started_ = false;
+    }
+
+    /// \param counter SYNC counter value, 0 if the SYNC counter is disabled
+    /// \param eventPending true if a mapped value changed since the last transmission
+    bool sync(uint8_t counter, bool eventPending)
+    {
+        if (interval_ == 0) {
+            return eventPending;
+        }
+        if (!started_) {
+            // with SYNC counter and start value the first transmission waits for the start value
+            const bool waitForStart = (startValue_ != 0) && (counter != 0);
+            if (waitForStart && counter != startValue_) {
+                return false;
             }
+            started_ = true;
+            remaining_ = waitForStart ? 1 : interval_;
+        }
+        if (--remaining_ == 0) {
+            remaining_ = interval_;
+            return true;
         }
         return false;
     }
 };
 
+/// Change counters of TPDO mappable objects
+/// setChanged() is lock-free on targets with atomic read-modify-write instructions and can
+/// be called from any thread or interrupt. Transmit PDOs compare the counters of their mapped
+/// objects to the values seen at the last check instead of being flagged by the producer.
+template<typename OD>
+class ValueChangeCounters
+{
+public:
+    static constexpr std::size_t Size = transmitPdoMappableEntryCount<OD>();
+    static constexpr uint16_t NoIndex = 0xFFFF;
+    static_assert(Size < NoIndex, "Too many TPDO mappable objects");
+
+    /// \return counter index of a TPDO mappable object, NoIndex for other objects
+    static constexpr uint16_t index(Address address)
+    {
+        const auto index = Index.lookup(address);
+        return index ? *index : NoIndex;
+    }
+
+    void setChanged(uint16_t index) { counters_[index].fetch_add(1); }
+    uint32_t count(uint16_t index) const { return counters_[index].load(); }
+
+private:
+    using IndexMap = ConstexprMap<Address, uint16_t, Size>;
+
+    static constexpr auto makeIndex() -> IndexMap
+    {
+        IndexMap index{};
+        if constexpr (requires { OD::transmitPdoMappableAddresses; }) {
+            index = IndexMap::fromSortedKeys(OD::transmitPdoMappableAddresses);
+        } else {
+            ConstexprMapBuilder<Address, uint16_t, Size> builder{};
+            for (const auto& [address, entry] : OD::map) {
+                if (entry.isTransmitPdoMappable()) {
+                    builder.insert(address, 0);
+                }
+            }
+            index = builder.buildMap();
+        }
+        // elements are iterated in key order
+        uint16_t position = 0;
+        for (auto&& [address, value] : index) {
+            value = position++;
+        }
+        return index;
+    }
+
+    static constexpr IndexMap Index = makeIndex();
+
+    std::array<std::atomic<uint32_t>, Size> counters_{};
+};
+
 enum class TransmitMode
 {
     OnSync,
@@ -55,13 +170,17 @@ modm::can::Message createPdoMessage(const TransmitPdo<OD>& pdo, uint16_t canId);
 template<typename OD>
 class TransmitPdo
 {
-private:
+public:
     static constexpr std::size_t MaxMappingCount{8};
 
-public:
+    /// Packs the mapped objects of a static mapping, see StaticPdoMapping
+    using StaticPackFunction = void(*)(void* context, uint8_t* data);
+
     void setCanId(uint32_t canId);
 
-    SdoErrorCode setActive();
+    /// Validate mappings and resolve them into a pack plan using the read handlers
+    /// \param context passed to handlers registered with a context parameter
+    SdoErrorCode setActive(const HandlerMap<OD>& handlers, void* context);
     void setInactive();
     bool isActive() const;
 
@@ -71,13 +190,56 @@ public:
     SdoErrorCode setMapping(uint_fast8_t index, PdoMapping mapping);
     PdoMapping mapping(uint_fast8_t index) const;
 
-    void sync();
+    /// Replace the mapping by a mapping fixed at compile time
+    /// The PDO must be inactive. The mapping can't be changed afterwards.
+    SdoErrorCode setStaticMapping(std::span<const PdoMapping> mappings, StaticPackFunction pack);
+    bool hasStaticMapping() const { return staticPack_ != nullptr; }
+
     void setValueUpdated();
 
-    template<typename Callback>
-    std::optional<modm::can::Message> nextMessage(Callback&& cb);
+    /// Skip event-driven transmissions if no mapped object changed since the last transmission
+    /// Objects without deadband change if their bytes differ. Transmissions of the event
+    /// timer are never skipped.
+    void setChangeOfValue(bool enabled)
+    {
+        // the payload is only recorded while enabled, the next event is always transmitted
+        changeOfValue_ = enabled;
+        lastPayloadValid_ = false;
+    }
+    bool changeOfValue() const { return changeOfValue_; }
+
+    /// Minimum absolute difference of mapped object index to the last transmitted value
+    /// which is considered a change, 0 for any change. Domains are not supported.
+    SdoErrorCode setDeadband(uint_fast8_t index, uint32_t deadband);
+    uint32_t deadband(uint_fast8_t index) const { return deadbands_[index]; }
+
+    /// Pack mapped objects again if image was published while packing, nullptr to disable
+    void setProcessImage(const ProcessImageBase* image) { processImage_ = image; }
+
+    /// Process received SYNC, returns the message to transmit for synchronous PDOs
+    /// \param counter SYNC counter value, 0 if the SYNC counter is disabled
+    /// \param changes change counters checked for changed mapped objects
+    std::optional<modm::can::Message> sync(uint8_t counter, const ValueChangeCounters<OD>& changes);
+
+    /// Returns the message to transmit for event-driven PDOs
+    std::optional<modm::can::Message> nextMessage(modm::PreciseTimestamp now, const ValueChangeCounters<OD>& changes);
+    /// \return true if nextMessage() would pack a message, the change of value check is not applied
+    bool isDue(modm::PreciseTimestamp now, const ValueChangeCounters<OD>& changes);
+    modm::PreciseDuration timeUntilNextMessage(modm::PreciseTimestamp now) const;
+
+    /// Exclusive access while processMessage() and update() of the node run on different threads
+    /// Never blocks, the caller skips the PDO or reports an error if the PDO is claimed.
+    bool tryClaim() { return !claimed_.test_and_set(std::memory_order_acquire); }
+    void release() { claimed_.clear(std::memory_order_release); }
+
+    /// 0: acyclic synchronous, 1-240: every n-th SYNC, 0xFE/0xFF: event-driven
+    SdoErrorCode setTransmissionType(uint8_t type);
+    uint8_t transmissionType() const;
+    TransmitMode transmitMode() const;
+
+    SdoErrorCode setSyncStartValue(uint8_t value);
+    uint8_t syncStartValue() const;
 
-    void setTransmitMode(TransmitMode mode);
     // TODO: change parameter types
     SdoErrorCode setEventTimeout(uint16_t milliseconds); // 0 to disable
     SdoErrorCode setInhibitTime(uint16_t inhibitTime_100us);
@@ -86,21 +248,52 @@ public:
 
     uint32_t cobId() const { return active_ ? canId_ : (canId_ | 0x8000'0000); }
     uint32_t canId() const { return canId_; }
+    uint8_t payloadSize() const { return payloadSize_; }
 private:
-    bool active_{false};
+    /// Mapped object resolved at activation time
+    struct PackEntry
+    {
+        ReadHandler handler;
+        uint8_t offset;
+        uint8_t size;
+    };
+
+    /// Checked by the transmit thread before claiming the PDO
+    std::atomic<bool> active_{false};
+    void* context_{};
     uint32_t canId_{};
     uint_fast8_t mappingCount_{};
     std::array<PdoMapping, MaxMappingCount> mappings_{};
-    std::array<DataType, MaxMappingCount> mappingTypes_{};
-    TransmitMode transmitMode_{};
+    std::array<PackEntry, MaxMappingCount> packPlan_{};
+    StaticPackFunction staticPack_{};
+    const ProcessImageBase* processImage_{};
+    /// Change of value mode, payload of the last transmission
+    bool changeOfValue_{false};
+    bool lastPayloadValid_{false};
+    std::array<uint8_t, 8> lastPayload_{};
+    std::array<uint32_t, MaxMappingCount> deadbands_{};
+    std::array<DataType, MaxMappingCount> dataTypes_{};
+    /// Change counter index and last seen count of each mapped object
+    std::array<uint16_t, MaxMappingCount> changeIndices_{};
+    std::array<uint32_t, MaxMappingCount> changeCounts_{};
+    uint8_t payloadSize_{};
+    uint8_t transmissionType_{0xFF};
     SendOnEvent sendOnEvent_{};
-    bool sync_{false};
+    SendOnSync sendOnSync_{};
+    std::atomic_flag claimed_{};
+
+    /// Set the updated flag if the change counter of a mapped object was incremented
+    void pollValueChanges(const ValueChangeCounters<OD>& changes);
 
     SdoErrorCode validateMapping(PdoMapping mapping);
     SdoErrorCode validateMappings();
+    SdoErrorCode buildPackPlan(const HandlerMap<OD>& handlers);
+
+    modm::can::Message getMessage();
+    void pack(uint8_t* data);
 
-    template<typename Callback>
-    std::optional<modm::can::Message> getMessage(Callback&& cb);
+    /// \return true if the payload differs from the last transmission, see setDeadband()
+    bool payloadChanged(const uint8_t* data) const;
 };
 
 }
@@ -2,7 +2,9 @@
 #define CANOPEN_TRANSMIT_PDO_CONFIGURATOR_HPP
 
 #include <cstdint>
+#include <utility>
 #include "object_dictionary_common.hpp"
+#include "pdo_common.hpp"
 
 namespace modm_canopen
 {
@@ -11,63 +13,99 @@ template<typename Device>
 class TransmitPdoConfigurator
 {
 public:
-    template<uint8_t pdo>
+    template<uint16_t pdo>
     constexpr void registerPdoConfigObjects(Device::Map& map)
     {
-        auto& tpdo = Device::transmitPdos_[pdo];
+        using OD = Device::ObjectDictionary;
+        constexpr bool hasSyncStartValue = hasEntry<OD>(Address{0x1800 + pdo, 6});
         // highest sub-index supported
         map.template setReadHandler<Address{0x1800 + pdo, 0}>(
-            +[]() -> uint8_t { return 5; });
+            +[]() -> uint8_t { return hasSyncStartValue ? 6 : 5; });
 
         // RPDO COB-ID
         map.template setReadHandler<Address{0x1800 + pdo, 1}>(
-            +[]() -> uint32_t { return tpdo.cobId(); });
+            +[](void* context) -> uint32_t { return transmitPdo(context, pdo).cobId(); });
 
         map.template setWriteHandler<Address{0x1800 + pdo, 1}>(
-            +[](uint32_t cobId) { return setTransmitPdoCobId(pdo, cobId); });
+            +[](void* context, uint32_t cobId) {
+                return configure(context, pdo, [cobId](Device& device, auto&) {
+                    return setTransmitPdoCobId(device, pdo, cobId);
+                });
+            });
 
+        // Transmission type, 0: acyclic sync, 1-240: cyclic sync, 0xFE/0xFF: async
         map.template setReadHandler<Address{0x1800 + pdo, 2}>(
-            // 0xFF: async
-            +[]() -> uint8_t { return 0xFF; });
+            +[](void* context) -> uint8_t { return transmitPdo(context, pdo).transmissionType(); });
 
         map.template setWriteHandler<Address{0x1800 + pdo, 2}>(
-            // 0xFF: async
-            +[](uint8_t transmitMode) -> SdoErrorCode { return transmitMode == 0xFF ? SdoErrorCode::NoError : SdoErrorCode::UnsupportedAccess; });
+            +[](void* context, uint8_t type) {
+                return configure(context, pdo, [type](Device&, auto& tpdo) {
+                    return tpdo.setTransmissionType(type);
+                });
+            });
 
         map.template setReadHandler<Address{0x1800 + pdo, 3}>(
-            +[]() -> uint16_t { return tpdo.inhibitTime(); });
+            +[](void* context) -> uint16_t { return transmitPdo(context, pdo).inhibitTime(); });
 
         map.template setWriteHandler<Address{0x1800 + pdo, 3}>(
-            +[](uint16_t inhibitTime) { return tpdo.setInhibitTime(inhibitTime); });
+            +[](void* context, uint16_t inhibitTime) {
+                return configure(context, pdo, [inhibitTime](Device&, auto& tpdo) {
+                    return tpdo.setInhibitTime(inhibitTime);
+                });
+            });
 
         map.template setReadHandler<Address{0x1800 + pdo, 5}>(
-            +[]() -> uint16_t { return tpdo.eventTimeout(); });
+            +[](void* context) -> uint16_t { return transmitPdo(context, pdo).eventTimeout(); });
 
         map.template setWriteHandler<Address{0x1800 + pdo, 5}>(
-            +[](uint16_t timeout_ms) { return tpdo.setEventTimeout(timeout_ms); });
+            +[](void* context, uint16_t timeout_ms) {
+                return configure(context, pdo, [timeout_ms](Device&, auto& tpdo) {
+                    return tpdo.setEventTimeout(timeout_ms);
+                });
+            });
+
+        if constexpr (hasSyncStartValue) {
+            map.template setReadHandler<Address{0x1800 + pdo, 6}>(
+                +[](void* context) -> uint8_t { return transmitPdo(context, pdo).syncStartValue(); });
+
+            map.template setWriteHandler<Address{0x1800 + pdo, 6}>(
+                +[](void* context, uint8_t value) {
+                    return configure(context, pdo, [value](Device&, auto& tpdo) {
+                        return tpdo.setSyncStartValue(value);
+                    });
+                });
+        }
     }
 
-    template<uint8_t pdo, uint8_t mappingIndex>
+    template<uint16_t pdo, uint8_t mappingIndex>
     constexpr void registerMappingObjects(Device::Map& map)
     {
-        auto& tpdo = Device::transmitPdos_[pdo];
         map.template setReadHandler<Address{0x1A00 + pdo, mappingIndex + 1}>(
-            +[]() -> uint32_t { return tpdo.mapping(mappingIndex).encode(); });
+            +[](void* context) -> uint32_t {
+                return transmitPdo(context, pdo).mapping(mappingIndex).encode();
+            });
 
         map.template setWriteHandler<Address{0x1A00 + pdo, mappingIndex + 1}>(
-            +[](uint32_t mapping) { return tpdo.setMapping(mappingIndex, PdoMapping::decode(mapping)); });
+            +[](void* context, uint32_t mapping) {
+                return configure(context, pdo, [mapping](Device&, auto& tpdo) {
+                    return tpdo.setMapping(mappingIndex, PdoMapping::decode(mapping));
+                });
+            });
     }
 
-    template<uint8_t pdo>
+    template<uint16_t pdo>
     constexpr void registerMappingConfigObjects(Device::Map& map)
     {
-        auto& tpdos = Device::transmitPdos_;
         // mapping count
         map.template setReadHandler<Address{0x1A00 + pdo, 0}>(
-            +[]() -> uint8_t { return tpdos[pdo].mappingCount(); });
+            +[](void* context) -> uint8_t { return transmitPdo(context, pdo).mappingCount(); });
 
         map.template setWriteHandler<Address{0x1A00 + pdo, 0}>(
-            +[](uint8_t count) { return tpdos[pdo].setMappingCount(count); });
+            +[](void* context, uint8_t count) {
+                return configure(context, pdo, [count](Device&, auto& tpdo) {
+                    return tpdo.setMappingCount(count);
+                });
+            });
         registerMappingObjects<pdo, 0>(map);
         registerMappingObjects<pdo, 1>(map);
         registerMappingObjects<pdo, 2>(map);
@@ -80,33 +118,60 @@ public:
 
     constexpr void registerHandlers(Device::Map& map)
     {
-        registerPdoConfigObjects<0>(map);
-        registerPdoConfigObjects<1>(map);
-        registerPdoConfigObjects<2>(map);
-        registerPdoConfigObjects<3>(map);
-        registerMappingConfigObjects<0>(map);
-        registerMappingConfigObjects<1>(map);
-        registerMappingConfigObjects<2>(map);
-        registerMappingConfigObjects<3>(map);
+        registerPdos(map, std::make_index_sequence<Device::TransmitPdoCount>{});
     }
 
 private:
-    static SdoErrorCode setTransmitPdoCobId(uint_fast8_t index, uint32_t cobId)
+    template<std::size_t... pdos>
+    constexpr void registerPdos(Device::Map& map, std::index_sequence<pdos...>)
+    {
+        (registerPdoConfigObjects<pdos>(map), ...);
+        (registerMappingConfigObjects<pdos>(map), ...);
+    }
+
+    static auto transmitPdo(void* context, std::size_t index) -> auto&
+    {
+        return static_cast<Device*>(context)->transmitPdos_[index];
+    }
+
+    /// Call function(device, tpdo) with the PDO claimed from a transmit thread running update()
+    template<typename Function>
+    static SdoErrorCode configure(void* context, std::size_t index, Function&& function)
     {
-        auto& tpdo = Device::transmitPdos_[index];
-        const uint32_t canId = 0x80 + 0x100 * (1 + index) + Device::nodeId();
+        auto& device = *static_cast<Device*>(context);
+        auto& tpdo = device.transmitPdos_[index];
+        if (!tpdo.tryClaim()) {
+            return SdoErrorCode::LocalControl;
+        }
+        const auto result = function(device, tpdo);
+        tpdo.release();
+        device.invalidateTransmitSchedule();
+        return result;
+    }
+
+    static SdoErrorCode setTransmitPdoCobId(Device& device, std::size_t index, uint32_t cobId)
+    {
+        auto& tpdo = device.transmitPdos_[index];
         const uint32_t canIdMask = (1u << 30) - 1;
-        // changing can id is not supported
-        if ((cobId & canIdMask) != canId) {
+        const uint32_t canId = cobId & canIdMask;
+        const bool enabled = !(cobId & (1u << 31));
+        if (enabled && isRestrictedPdoCanId(canId)) {
             return SdoErrorCode::InvalidValue;
         }
-        const bool enabled = !(cobId & (1u << 31));
+        // the can id can only be changed while the PDO is disabled
+        if (canId != tpdo.canId()) {
+            if (tpdo.isActive()) {
+                return SdoErrorCode::InvalidValue;
+            }
+            tpdo.setCanId(canId);
+        }
+        SdoErrorCode result = SdoErrorCode::NoError;
         if (enabled) {
-            return tpdo.setActive();
+            result = tpdo.setActive(Device::accessHandlers, &device);
         } else {
             tpdo.setInactive();
-            return SdoErrorCode::NoError;
         }
+        return result;
     }
 };
 
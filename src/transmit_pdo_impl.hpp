@@ -12,12 +12,25 @@ void TransmitPdo<OD>::setCanId(uint32_t canId)
 }
 
 template<typename OD>
-SdoErrorCode TransmitPdo<OD>::setActive()
+SdoErrorCode TransmitPdo<OD>::setActive(const HandlerMap<OD>& handlers, void* context)
 {
-    if(const auto error = validateMappings(); error != SdoErrorCode::NoError) {
-        return error;
+    // static mappings are validated at compile time
+    if (!staticPack_) {
+        if(const auto error = validateMappings(); error != SdoErrorCode::NoError) {
+            return error;
+        }
+        if(const auto error = buildPackPlan(handlers); error != SdoErrorCode::NoError) {
+            return error;
+        }
     }
 
+    for (uint_fast8_t i = 0; i < mappingCount_; ++i) {
+        changeIndices_[i] = ValueChangeCounters<OD>::index(mappings_[i].address);
+        dataTypes_[i] = OD::map.lookup(mappings_[i].address)->dataType;
+    }
+    lastPayloadValid_ = false;
+    sendOnSync_.reset();
+    context_ = context;
     active_ = true;
 
     return SdoErrorCode::NoError;
@@ -38,7 +51,7 @@ bool TransmitPdo<OD>::isActive() const
 template<typename OD>
 SdoErrorCode TransmitPdo<OD>::setMappingCount(uint_fast8_t count)
 {
-    if (active_ || count > MaxMappingCount) {
+    if (active_ || staticPack_ || count > MaxMappingCount) {
         return SdoErrorCode::UnsupportedAccess;
     }
 
@@ -48,8 +61,6 @@ SdoErrorCode TransmitPdo<OD>::setMappingCount(uint_fast8_t count)
         if (error != SdoErrorCode::NoError) {
             return error;
         }
-        const auto entry = OD::map.lookup(mappings_[i].address);
-        mappingTypes_[i] = entry->dataType;
         totalSize += mappings_[i].bitLength;
     }
     if (totalSize > 8*8) {
@@ -69,6 +80,10 @@ uint_fast8_t TransmitPdo<OD>::mappingCount() const
 template<typename OD>
 SdoErrorCode TransmitPdo<OD>::setMapping(uint_fast8_t index, PdoMapping mapping)
 {
+    // the pack plan of an active PDO would be outdated
+    if (active_ || staticPack_) {
+        return SdoErrorCode::UnsupportedAccess;
+    }
     const auto error = validateMapping(mapping);
     if (error == SdoErrorCode::NoError) {
         mappings_[index] = mapping;
@@ -83,29 +98,54 @@ PdoMapping TransmitPdo<OD>::mapping(uint_fast8_t index) const
 }
 
 template<typename OD>
-template<typename Callback>
-std::optional<modm::can::Message> TransmitPdo<OD>::getMessage(Callback&& cb)
+SdoErrorCode TransmitPdo<OD>::setStaticMapping(std::span<const PdoMapping> mappings, StaticPackFunction pack)
+{
+    if (active_ || mappings.size() > MaxMappingCount) {
+        return SdoErrorCode::UnsupportedAccess;
+    }
+    unsigned totalSize = 0;
+    for (std::size_t i = 0; i < mappings.size(); ++i) {
+        mappings_[i] = mappings[i];
+        totalSize += mappings[i].bitLength;
+    }
+    mappingCount_ = mappings.size();
+    payloadSize_ = totalSize / 8;
+    staticPack_ = pack;
+    return SdoErrorCode::NoError;
+}
+
+template<typename OD>
+modm::can::Message TransmitPdo<OD>::getMessage()
 {
     sendOnEvent_.updated_ = false;
-    modm::can::Message message{canId_};
+    modm::can::Message message{canId_, payloadSize_};
     message.setExtended(false);
 
-    if (active_ && mappingCount_ > 0) {
-        std::size_t index = 0;
-        for (uint_fast8_t i = 0; i < mappingCount_; ++i) {
-            const auto address = mappings_[i].address;
-            const auto size = mappings_[i].bitLength / 8;
-            const auto value = std::forward<Callback>(cb)(address);
-            const auto* ptr = std::get_if<Value>(&value);
-            if (!ptr) return std::nullopt;
-            valueToBytes(*ptr, message.data + index);
-            index += size;
-        }
-        message.length = index;
+    if (processImage_) {
+        uint32_t sequence;
+        do {
+            sequence = processImage_->beginRead();
+            pack(message.data);
+        } while (!processImage_->validate(sequence));
+    } else {
+        pack(message.data);
     }
     return message;
 }
 
+template<typename OD>
+void TransmitPdo<OD>::pack(uint8_t* data)
+{
+    if (staticPack_) {
+        staticPack_(context_, data);
+        return;
+    }
+    for (uint_fast8_t i = 0; i < mappingCount_; ++i) {
+        const auto& entry = packPlan_[i];
+        callReadHandler(entry.handler, context_, data + entry.offset);
+    }
+}
+
 template<typename OD>
 SdoErrorCode TransmitPdo<OD>::validateMappings()
 {
@@ -115,8 +155,6 @@ SdoErrorCode TransmitPdo<OD>::validateMappings()
         if (error != SdoErrorCode::NoError) {
             return error;
         }
-        const auto entry = OD::map.lookup(mappings_[i].address);
-        mappingTypes_[i] = entry->dataType;
         totalSize += mappings_[i].bitLength;
     }
     if (totalSize > 8*8) {
@@ -125,6 +163,23 @@ SdoErrorCode TransmitPdo<OD>::validateMappings()
     return SdoErrorCode::NoError;
 }
 
+template<typename OD>
+SdoErrorCode TransmitPdo<OD>::buildPackPlan(const HandlerMap<OD>& handlers)
+{
+    uint8_t offset = 0;
+    for (uint_fast8_t i = 0; i < mappingCount_; ++i) {
+        const auto handler = handlers.lookupReadHandler(mappings_[i].address);
+        if (!handler || std::holds_alternative<std::monostate>(*handler)) {
+            return SdoErrorCode::PdoMappingError;
+        }
+        const uint8_t size = mappings_[i].bitLength / 8;
+        packPlan_[i] = PackEntry{*handler, offset, size};
+        offset += size;
+    }
+    payloadSize_ = offset;
+    return SdoErrorCode::NoError;
+}
+
 template<typename OD>
 SdoErrorCode TransmitPdo<OD>::validateMapping(PdoMapping mapping)
 {
@@ -142,9 +197,16 @@ SdoErrorCode TransmitPdo<OD>::validateMapping(PdoMapping mapping)
 }
 
 template<typename OD>
-void TransmitPdo<OD>::sync()
+std::optional<modm::can::Message> TransmitPdo<OD>::sync(uint8_t counter, const ValueChangeCounters<OD>& changes)
 {
-    sync_ = true;
+    if (!active_ || transmitMode() != TransmitMode::OnSync) {
+        return std::nullopt;
+    }
+    pollValueChanges(changes);
+    if (sendOnSync_.sync(counter, sendOnEvent_.updated_)) {
+        return getMessage();
+    }
+    return std::nullopt;
 }
 
 template<typename OD>
@@ -154,23 +216,133 @@ void TransmitPdo<OD>::setValueUpdated()
 }
 
 template<typename OD>
-template<typename Callback>
-std::optional<modm::can::Message> TransmitPdo<OD>::nextMessage(Callback&& cb)
+std::optional<modm::can::Message> TransmitPdo<OD>::nextMessage(modm::PreciseTimestamp now,
+                                                               const ValueChangeCounters<OD>& changes)
 {
-    const bool send = (transmitMode_ == TransmitMode::OnSync && sync_)
-        || sendOnEvent_.send();
-
-    if (send) {
-        return getMessage(std::forward<Callback>(cb));
-    } else {
+    if (transmitMode() != TransmitMode::OnEvent) {
         return std::nullopt;
     }
+    pollValueChanges(changes);
+    if (!sendOnEvent_.due(now)) {
+        return std::nullopt;
+    }
+    const auto message = getMessage();
+    if (changeOfValue_) {
+        // skipped transmissions don't restart the event timer and the inhibit time
+        if (!sendOnEvent_.timerExpired(now) && !payloadChanged(message.data)) {
+            return std::nullopt;
+        }
+        std::memcpy(lastPayload_.data(), message.data, payloadSize_);
+        lastPayloadValid_ = true;
+    }
+    sendOnEvent_.setSent(now);
+    return message;
+}
+
+template<typename OD>
+bool TransmitPdo<OD>::isDue(modm::PreciseTimestamp now, const ValueChangeCounters<OD>& changes)
+{
+    if (transmitMode() != TransmitMode::OnEvent) {
+        return false;
+    }
+    pollValueChanges(changes);
+    return sendOnEvent_.due(now);
+}
+
+template<typename OD>
+bool TransmitPdo<OD>::payloadChanged(const uint8_t* data) const
+{
+    if (!lastPayloadValid_) {
+        return true;
+    }
+    uint8_t offset = 0;
+    for (uint_fast8_t i = 0; i < mappingCount_; ++i) {
+        const uint8_t size = mappings_[i].bitLength / 8;
+        const uint8_t* last = lastPayload_.data() + offset;
+        const uint8_t* current = data + offset;
+        offset += size;
+        if (deadbands_[i] == 0) {
+            if (std::memcmp(last, current, size) != 0) {
+                return true;
+            }
+        } else if (detail::valueDifference(dataTypes_[i], last, current) >= deadbands_[i]) {
+            return true;
+        }
+    }
+    return false;
+}
+
+template<typename OD>
+SdoErrorCode TransmitPdo<OD>::setDeadband(uint_fast8_t index, uint32_t deadband)
+{
+    if (index >= MaxMappingCount) {
+        return SdoErrorCode::UnsupportedAccess;
+    }
+    deadbands_[index] = deadband;
+    return SdoErrorCode::NoError;
+}
+
+template<typename OD>
+void TransmitPdo<OD>::pollValueChanges(const ValueChangeCounters<OD>& changes)
+{
+    for (uint_fast8_t i = 0; i < mappingCount_; ++i) {
+        const auto count = changes.count(changeIndices_[i]);
+        if (count != changeCounts_[i]) {
+            changeCounts_[i] = count;
+            sendOnEvent_.updated_ = true;
+        }
+    }
+}
+
+template<typename OD>
+modm::PreciseDuration TransmitPdo<OD>::timeUntilNextMessage(modm::PreciseTimestamp now) const
+{
+    if (!active_ || transmitMode() != TransmitMode::OnEvent) {
+        return modm::PreciseDuration::max();
+    }
+    return sendOnEvent_.timeUntilSend(now);
+}
+
+template<typename OD>
+SdoErrorCode TransmitPdo<OD>::setTransmissionType(uint8_t type)
+{
+    const bool synchronous = (type <= 240);
+    const bool eventDriven = (type == 0xFE) || (type == 0xFF);
+    if (!synchronous && !eventDriven) {
+        return SdoErrorCode::InvalidValue;
+    }
+    transmissionType_ = type;
+    sendOnSync_.interval_ = synchronous ? type : 0;
+    sendOnSync_.reset();
+    // synchronous transmissions don't record the payload for change of value
+    lastPayloadValid_ = false;
+    return SdoErrorCode::NoError;
+}
+
+template<typename OD>
+uint8_t TransmitPdo<OD>::transmissionType() const
+{
+    return transmissionType_;
+}
+
+template<typename OD>
+TransmitMode TransmitPdo<OD>::transmitMode() const
+{
+    return (transmissionType_ <= 240) ? TransmitMode::OnSync : TransmitMode::OnEvent;
+}
+
+template<typename OD>
+SdoErrorCode TransmitPdo<OD>::setSyncStartValue(uint8_t value)
+{
+    sendOnSync_.startValue_ = value;
+    sendOnSync_.reset();
+    return SdoErrorCode::NoError;
 }
 
 template<typename OD>
-void TransmitPdo<OD>::setTransmitMode(TransmitMode mode)
+uint8_t TransmitPdo<OD>::syncStartValue() const
 {
-    transmitMode_ = mode;
+    return sendOnSync_.startValue_;
 }
 
 template<typename OD>
@@ -0,0 +1,183 @@
+#!/usr/bin/env python3
+
+"""Generate synthetic EDS files of configurable size for scaling tests"""
+
+import argparse
+import random
+import sys
+
+type_codes = {
+    "i8" : 0x0002,
+    "i16" : 0x0003,
+    "i32" : 0x0004,
+    "u8" : 0x0005,
+    "u16" : 0x0006,
+    "u32" : 0x0007,
+    "i64" : 0x0015,
+    "u64" : 0x001B,
+}
+
+# read-only and read-write values, "rwr" and "rww" values are PDO mappable
+access_types = ["ro", "rw", "rwr", "rww"]
+
+
+class EdsWriter:
+    def __init__(self):
+        self.lines = []
+
+    def section(self, name, values):
+        self.lines.append("[{}]".format(name))
+        self.lines += ["{}={}".format(key, value) for key, value in values.items()]
+        self.lines.append("")
+
+    def variable(self, key, name, data_type, access_type, default=0, mapping=False):
+        self.section(key, {"ParameterName" : name,
+                           "ObjectType" : "0x7",
+                           "DataType" : "0x{:04X}".format(data_type),
+                           "AccessType" : access_type,
+                           "DefaultValue" : default,
+                           "PDOMapping" : int(mapping)})
+
+    def record(self, key, name, subobjects):
+        self.section(key, {"ParameterName" : name,
+                           "ObjectType" : "0x9",
+                           "SubNumber" : len(subobjects)})
+        # sub-indices are written in decimal as expected by od_generator.py
+        for subindex, args in subobjects:
+            self.variable("{}sub{}".format(key, subindex), *args)
+
+    def object_list(self, name, indices):
+        values = {"SupportedObjects" : len(indices)}
+        values.update({str(i + 1) : "0x{:04X}".format(index) for i, index in enumerate(indices)})
+        self.section(name, values)
+
+    def text(self):
+        # EDS files use DOS line endings
+        return "\r\n".join(self.lines)
+
+
+def parse_type_mix(string):
+    mix = {}
+    for item in string.split(","):
+        name, _, weight = item.partition(":")
+        if name not in type_codes:
+            raise ValueError("Unknown data type '{}', use one of {}".format(name, ", ".join(type_codes)))
+        mix[name] = float(weight) if weight else 1.0
+    return mix
+
+
+def pdo_cob_id(base, pdo):
+    # default COB-IDs exist for the first four PDOs only
+    return "$NODEID+0x{:X}".format(base + 0x100 * pdo) if pdo < 4 else "0x80000000"
+
+
+def write_pdo_objects(eds, rpdo_count, tpdo_count):
+    for pdo in range(rpdo_count):
+        eds.record("{:X}".format(0x1400 + pdo), "RPDO{} Communication Parameter".format(pdo + 1), [
+            (0, ("Number of entries", 0x5, "ro", 2)),
+            (1, ("COB-ID RPDO{}".format(pdo + 1), 0x7, "rw", pdo_cob_id(0x200, pdo))),
+            (2, ("Transmission type", 0x5, "rw", 255))])
+    for pdo in range(rpdo_count):
+        eds.record("{:X}".format(0x1600 + pdo), "RPDO{} Mapping Parameter".format(pdo + 1),
+                   [(0, ("Number of entries", 0x5, "rw", 0))] +
+                   [(k, ("Mapped object {}".format(k), 0x7, "rw", 0)) for k in range(1, 9)])
+    for pdo in range(tpdo_count):
+        eds.record("{:X}".format(0x1800 + pdo), "TPDO{} Communication Parameter".format(pdo + 1), [
+            (0, ("Number of entries", 0x5, "ro", 5)),
+            (1, ("COB-ID TPDO{}".format(pdo + 1), 0x7, "rw", pdo_cob_id(0x180, pdo))),
+            (2, ("Transmission type", 0x5, "rw", 255)),
+            (3, ("Inhibit Time", 0x6, "rw", 0)),
+            (5, ("Event timer", 0x6, "rw", 0))])
+    for pdo in range(tpdo_count):
+        eds.record("{:X}".format(0x1A00 + pdo), "TPDO{} Mapping Parameter".format(pdo + 1),
+                   [(0, ("Number of entries", 0x5, "rw", 0))] +
+                   [(k, ("Mapped object {}".format(k), 0x7, "rw", 0)) for k in range(1, 9)])
+
+
+def write_manufacturer_objects(eds, entry_count, record_size, type_mix, rng):
+    """Create entry_count manufacturer specific entries starting at index 0x2000"""
+    names = list(type_mix)
+    weights = [type_mix[name] for name in names]
+
+    def random_value(name):
+        data_type = type_codes[rng.choices(names, weights)[0]]
+        access_type = rng.choice(access_types)
+        return (name, data_type, access_type, 0, access_type in ("rwr", "rww"))
+
+    indices = []
+    remaining = entry_count
+    while remaining > 0:
+        index = 0x2000 + len(indices)
+        if index > 0x5FFF:
+            raise ValueError("Too many entries for the manufacturer specific index range")
+        key = "{:X}".format(index)
+        if record_size == 0 or remaining == 1:
+            eds.variable(key, *random_value("Value {:X}".format(index)))
+            remaining -= 1
+        else:
+            count = min(record_size, remaining - 1)
+            subobjects = [(0, ("Highest sub-index supported", 0x5, "ro", count))]
+            subobjects += [(k, random_value("Value {:X}sub{}".format(index, k))) for k in range(1, count + 1)]
+            eds.record(key, "Record {:X}".format(index), subobjects)
+            remaining -= count + 1
+        indices.append(index)
+    return indices
+
+
+def generate_eds(entry_count, record_size=8, type_mix=None, rpdo_count=4, tpdo_count=4, seed=0):
+    type_mix = type_mix or {name : 1.0 for name in type_codes}
+    rng = random.Random(seed)
+    communication = EdsWriter()
+    write_pdo_objects(communication, rpdo_count, tpdo_count)
+    manufacturer = EdsWriter()
+    manufacturer_indices = write_manufacturer_objects(manufacturer, entry_count, record_size, type_mix, rng)
+
+    eds = EdsWriter()
+    eds.section("FileInfo", {"CreatedBy" : "eds_generator.py",
+                             "Description" : "Synthetic device with {} entries".format(entry_count),
+                             "FileVersion" : "0x01",
+                             "FileRevision" : "0x01",
+                             "EDSVersion" : "4"})
+    eds.section("DeviceInfo", {"VendorName" : "None",
+                               "VendorNumber" : "0x00000000",
+                               "ProductName" : "Synthetic",
+                               "Granularity" : 8,
+                               "NrOfRXPDO" : rpdo_count,
+                               "NrOfTXPDO" : tpdo_count})
+    # mandatory objects require application handlers
+    eds.object_list("MandatoryObjects", [])
+    eds.object_list("OptionalObjects", [0x1400 + i for i in range(rpdo_count)] +
+                                       [0x1600 + i for i in range(rpdo_count)] +
+                                       [0x1800 + i for i in range(tpdo_count)] +
+                                       [0x1A00 + i for i in range(tpdo_count)])
+    eds.lines += communication.lines
+    eds.object_list("ManufacturerObjects", manufacturer_indices)
+    eds.lines += manufacturer.lines
+    return eds.text()
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("entries", type=int, help="number of manufacturer specific object dictionary entries")
+    parser.add_argument("output", nargs="?", default="-", help="output file, '-' for stdout")
+    parser.add_argument("--record-size", type=int, default=8,
+                        help="sub-entries per record, 0 to generate variables only (default: 8)")
+    parser.add_argument("--types", type=parse_type_mix, default=None,
+                        help="weighted data type mix, e.g. 'u8:1,u32:4,i16' (default: all types equally)")
+    parser.add_argument("--rpdo", type=int, default=4, help="number of receive PDOs (default: 4)")
+    parser.add_argument("--tpdo", type=int, default=4, help="number of transmit PDOs (default: 4)")
+    parser.add_argument("--seed", type=int, default=0, help="random seed for types and access types")
+    args = parser.parse_args()
+
+    if not 0 <= args.record_size <= 254:
+        parser.error("record size must be in range 0-254")
+    eds = generate_eds(args.entries, args.record_size, args.types, args.rpdo, args.tpdo, args.seed)
+    if args.output == "-":
+        sys.stdout.write(eds)
+    else:
+        with open(args.output, "w", newline="") as out:
+            out.write(eds)
+
+
+if __name__ == "__main__":
+    main()
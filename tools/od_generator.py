@@ -1,5 +1,6 @@
 #!/usr/bin/env python3
 
+import argparse
 import jinja2
 import configparser
 import sys
@@ -14,6 +15,12 @@ class DataType(IntEnum):
     UNSIGNED8 = 0x0005
     UNSIGNED16 = 0x0006
     UNSIGNED32 = 0x0007
+    VISIBLE_STRING = 0x0009
+    OCTET_STRING = 0x000A
+    UNICODE_STRING = 0x000B
+    DOMAIN = 0x000F
+    INTEGER64 = 0x0015
+    UNSIGNED64 = 0x001B
 
 class ObjectType(IntEnum):
     NULL = 0x00
@@ -32,30 +39,44 @@ class AccessType(Enum):
     ReadWriteWritePdo = "rww"
     Const = "const"
 
-Entry = namedtuple("Entry", "name address data_type access_type pdo_mapping")
+Entry = namedtuple("Entry", "name address data_type access_type pdo_mapping default_value")
 Address = namedtuple("Address", "index subindex")
 
 
 def main():
-    argc = len(sys.argv)
-    if argc not in (2, 3):
-        print("Usage: od_generator [eds filename] [output file]", file=sys.stderr)
-        sys.exit(1)
-
-    header_data = generate_data_header(sys.argv[1])
-    if argc == 2 or sys.argv[2] == "-":
+    parser = argparse.ArgumentParser(description="Generate object dictionary header from EDS file")
+    parser.add_argument("eds_file", help="EDS file")
+    parser.add_argument("output", nargs="?", default="-", help="output file, '-' for stdout")
+    parser.add_argument("--storage", action="store_true",
+                        help="allocate storage initialized from DefaultValue for objects without handlers")
+    args = parser.parse_args()
+
+    header_data = generate_data_header(args.eds_file, args.storage)
+    if args.output == "-":
         sys.stdout.write(header_data)
     else:
-        with open(sys.argv[2], "wt") as out:
+        with open(args.output, "wt") as out:
             out.write(header_data)
 
 
-def generate_data_header(eds_filename):
+def generate_data_header(eds_filename, storage=False):
     env = create_jinja2_env()
     env.template = env.get_template("od_data.hpp.j2")
     eds = load_eds_file(eds_filename)
     entries = read_all_objects(eds)
-    return env.template.render({"entries" : entries, "entry_count" : len(entries)})
+    rpdo_count = read_pdo_count(eds, "NrOfRXPDO", 0x1400)
+    tpdo_count = read_pdo_count(eds, "NrOfTXPDO", 0x1800)
+    check_pdo_objects(entries, rpdo_count, 0x1400, 0x1600)
+    check_pdo_objects(entries, tpdo_count, 0x1800, 0x1A00)
+    # sorted tables are used directly by the library instead of sorting during compilation
+    entries = sorted(entries, key=lambda entry: entry.address)
+    storage_entries = [e for e in entries if has_storage(e)] if storage else []
+    return env.template.render({"entries" : entries,
+                                "storage_entries" : storage_entries,
+                                "readable" : [e.address for e in entries if is_readable(e)],
+                                "writable" : [e.address for e in entries if is_writable(e)],
+                                "transmit_pdo_mappable" : [e.address for e in entries if is_transmit_pdo_mappable(e)],
+                                "rpdo_count" : rpdo_count, "tpdo_count" : tpdo_count})
 
 
 def key_to_address(key):
@@ -112,7 +133,8 @@ def read_object(eds, key, recursive=True):
         access_type = AccessType(obj["AccessType"])
         mapping = bool(parse_eds_number(obj["PDOMapping"]))
         name = obj["ParameterName"].strip()
-        return [Entry(name, key_to_address(key), data_type, access_type, mapping)]
+        default_value = obj.get("DefaultValue", "").strip()
+        return [Entry(name, key_to_address(key), data_type, access_type, mapping, default_value)]
     elif object_type in (ObjectType.RECORD, ObjectType.ARRAY):
         if not recursive:
             raise ValueError("Key {} is not a value".format(key))
@@ -140,9 +162,16 @@ data_type_map = {
     DataType.INTEGER8 : "Int8",
     DataType.INTEGER16 : "Int16",
     DataType.INTEGER32 : "Int32",
+    DataType.INTEGER64 : "Int64",
     DataType.UNSIGNED8 : "UInt8",
     DataType.UNSIGNED16 : "UInt16",
-    DataType.UNSIGNED32 : "UInt32"
+    DataType.UNSIGNED32 : "UInt32",
+    DataType.UNSIGNED64 : "UInt64",
+    # strings have variable size and are accessed like domains
+    DataType.VISIBLE_STRING : "Domain",
+    DataType.OCTET_STRING : "Domain",
+    DataType.UNICODE_STRING : "Domain",
+    DataType.DOMAIN : "Domain"
 }
 
 def convert_data_type(eds_type):
@@ -163,6 +192,85 @@ def convert_access_type(eds_type):
     return "AccessType::" + access_type_map[eds_type]
 
 
+# must match the Entry member functions in object_dictionary_common.hpp
+def is_readable(entry):
+    return access_type_map[entry.access_type] != "WriteOnly"
+
+
+def is_writable(entry):
+    return access_type_map[entry.access_type] != "ReadOnly"
+
+
+def is_transmit_pdo_mappable(entry):
+    return entry.pdo_mapping and access_type_map[entry.access_type] in ("ReadOnly", "ReadWriteReadPdo")
+
+
+# objects accessed through handlers of the library protocols, see *_configurator.hpp
+protocol_objects = [(0x1005, 0x1005), (0x1007, 0x1007), (0x1019, 0x1019), (0x1400, 0x1BFF)]
+
+storage_types = {
+    DataType.INTEGER8 : ("int8_t", True, 8),
+    DataType.INTEGER16 : ("int16_t", True, 16),
+    DataType.INTEGER32 : ("int32_t", True, 32),
+    DataType.INTEGER64 : ("int64_t", True, 64),
+    DataType.UNSIGNED8 : ("uint8_t", False, 8),
+    DataType.UNSIGNED16 : ("uint16_t", False, 16),
+    DataType.UNSIGNED32 : ("uint32_t", False, 32),
+    DataType.UNSIGNED64 : ("uint64_t", False, 64),
+}
+
+def has_storage(entry):
+    """Objects with a fixed size value and a default independent of the node id"""
+    if entry.data_type not in storage_types or "$NODEID" in entry.default_value.upper():
+        return False
+    return not any(first <= entry.address.index <= last for first, last in protocol_objects)
+
+
+def storage_type(entry):
+    return storage_types[entry.data_type][0]
+
+
+def storage_name(entry):
+    return "object{:04X}sub{}".format(entry.address.index, entry.address.subindex)
+
+
+def storage_default(entry):
+    """C++ literal of the EDS default value, empty defaults are 0"""
+    _, signed, bits = storage_types[entry.data_type]
+    value = parse_eds_number(entry.default_value) if entry.default_value else 0
+    minimum, maximum = (-(1 << (bits - 1)), (1 << (bits - 1)) - 1) if signed else (0, (1 << bits) - 1)
+    if not minimum <= value <= maximum:
+        raise ValueError("Default value {} of 0x{:x}:{} is out of range"
+                         .format(entry.default_value, entry.address.index, entry.address.subindex))
+    if not signed:
+        return hex(value)
+    # the most negative value can't be written as a single literal
+    return str(value) if value != minimum else "{} - 1".format(minimum + 1)
+
+
+MAX_PDO_COUNT = 512
+
+def read_pdo_count(eds, key, communication_index):
+    if "DeviceInfo" in eds and key in eds["DeviceInfo"]:
+        count = parse_eds_number(eds["DeviceInfo"][key])
+    else:
+        # count consecutive PDO communication parameter objects
+        count = 0
+        while count < MAX_PDO_COUNT and "{:X}".format(communication_index + count) in eds:
+            count += 1
+    if count > MAX_PDO_COUNT:
+        raise ValueError("{} = {} exceeds the maximum of {} PDOs".format(key, count, MAX_PDO_COUNT))
+    return count
+
+
+def check_pdo_objects(entries, count, communication_index, mapping_index):
+    addresses = set(entry.address for entry in entries)
+    for pdo in range(count):
+        for index in (communication_index + pdo, mapping_index + pdo):
+            if Address(index, 0) not in addresses:
+                raise ValueError("PDO {} is missing object 0x{:x}".format(pdo + 1, index))
+
+
 def check_entries(entries):
     address_set = set()
     for entry in entries:
@@ -181,6 +289,9 @@ def create_jinja2_env():
     env.filters["hex"] = lambda number: hex(int(number))
     env.filters["data_type"] = convert_data_type
     env.filters["access_type"] = convert_access_type
+    env.filters["storage_type"] = storage_type
+    env.filters["storage_name"] = storage_name
+    env.filters["storage_default"] = storage_default
     return env
 
 
@@ -0,0 +1,199 @@
+#!/usr/bin/env python3
+
+"""Measure compile time, compiler memory, binary size and lookup latency of generated
+object dictionaries over a range of sizes, results are written as JSON
+
+The device variant compiles a complete CanopenDevice including the PDO configurators and
+requires the modm headers, e.g. of a hosted modm build, passed with --modm-include."""
+
+import argparse
+import json
+import os
+import shlex
+import shutil
+import subprocess
+import sys
+import tempfile
+import time
+from pathlib import Path
+
+import eds_generator
+import od_generator
+
+benchmark_source = r"""
+#include <modm-canopen/handler_map.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace modm_canopen;
+using OD = generated::DefaultObjects;
+
+// instantiate the compile time tables built for every device
+constexpr HandlerMap<OD> handlers{};
+static_assert(transmitPdoMappableEntryCount<OD>() <= OD::map.size());
+
+int main()
+{
+    constexpr std::size_t Iterations = 1'000'000;
+    std::vector<Address> addresses;
+    for (const auto& [address, entry] : OD::map) {
+        addresses.push_back(address);
+    }
+    std::shuffle(addresses.begin(), addresses.end(), std::mt19937{42});
+
+    double best = 1e9;
+    std::size_t found = 0;
+    for (int run = 0; run < 5; ++run) {
+        const auto start = std::chrono::steady_clock::now();
+        for (std::size_t i = 0; i < Iterations; ++i) {
+            found += bool(OD::map.lookup(addresses[i % addresses.size()]));
+        }
+        const std::chrono::duration<double, std::nano> duration = std::chrono::steady_clock::now() - start;
+        best = std::min(best, duration.count() / Iterations);
+    }
+    std::printf("%.3f %zu\n", best, found + bool(handlers.lookupReadHandler(addresses[0])));
+}
+"""
+
+# objects without handlers use generated storage, the translation unit is compiled only
+device_source = r"""
+#include <modm-canopen/canopen_device.hpp>
+
+using Device = modm_canopen::CanopenDevice<modm_canopen::generated::DefaultObjects>;
+using Send = void(*)(const modm::can::Message&);
+
+void initialize(uint8_t nodeId)
+{
+    Device::initialize(nodeId);
+}
+
+void processMessage(const modm::can::Message& message, Send send)
+{
+    Device::processMessage(message, send);
+}
+
+modm::PreciseDuration update(Send send)
+{
+    return Device::update(send);
+}
+"""
+
+
+def run_measured(command):
+    """Run command, return wall time in seconds and peak resident memory in KiB"""
+    start = time.monotonic()
+    process = subprocess.Popen(command)
+    _, status, usage = os.wait4(process.pid, 0)
+    duration = time.monotonic() - start
+    process.returncode = os.waitstatus_to_exitcode(status)
+    if process.returncode != 0:
+        raise RuntimeError("Command failed: {}".format(" ".join(command)))
+    return duration, usage.ru_maxrss
+
+
+def text_size(binary):
+    size = shutil.which("size")
+    if not size:
+        return None
+    output = subprocess.check_output([size, str(binary)], text=True).splitlines()
+    return int(output[1].split()[0])
+
+
+def prepare_include_dir(include_dir, eds_file, storage):
+    shutil.copytree(Path(__file__).resolve().parents[1] / "src", include_dir / "modm-canopen")
+    (include_dir / "modm-canopen" / "generated").mkdir(exist_ok=True)
+    with open(include_dir / "modm-canopen" / "generated" / "object_dictionary.hpp", "w") as header:
+        header.write(od_generator.generate_data_header(eds_file, storage))
+
+
+def benchmark_device(size_dir, eds_file, args):
+    include_dir = size_dir / "device_include"
+    prepare_include_dir(include_dir, eds_file, storage=True)
+
+    source = size_dir / "device.cpp"
+    source.write_text(device_source)
+    obj = size_dir / "device.o"
+    includes = [flag for path in args.modm_include for flag in ("-I", path)]
+    command = [args.cxx, "-std=c++20", *shlex.split(args.cxxflags), *includes,
+               "-I", str(include_dir), "-c", str(source), "-o", str(obj)]
+    compile_time, compile_memory = run_measured(command)
+    return {
+        "compile_time_s" : round(compile_time, 3),
+        "compiler_peak_memory_kib" : compile_memory,
+        "text_size_bytes" : text_size(obj),
+    }
+
+
+def benchmark(entries, args, work_dir):
+    size_dir = work_dir / str(entries)
+    size_dir.mkdir(parents=True)
+
+    eds_file = size_dir / "device.eds"
+    with open(eds_file, "w", newline="") as eds:
+        eds.write(eds_generator.generate_eds(entries, args.record_size, args.types,
+                                             args.rpdo, args.tpdo, args.seed))
+    include_dir = size_dir / "include"
+    prepare_include_dir(include_dir, eds_file, storage=False)
+
+    source = size_dir / "main.cpp"
+    source.write_text(benchmark_source)
+    binary = size_dir / "benchmark"
+    command = [args.cxx, "-std=c++20", *shlex.split(args.cxxflags),
+               "-I", str(include_dir), str(source), "-o", str(binary)]
+    compile_time, compile_memory = run_measured(command)
+
+    output = subprocess.check_output([str(binary)], text=True).split()
+    return {
+        "entries" : entries,
+        "compile_time_s" : round(compile_time, 3),
+        "compiler_peak_memory_kib" : compile_memory,
+        "binary_size_bytes" : binary.stat().st_size,
+        "text_size_bytes" : text_size(binary),
+        "lookup_ns" : float(output[0]),
+        "device" : benchmark_device(size_dir, eds_file, args) if args.modm_include else None,
+    }
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("sizes", type=int, nargs="*", default=[100, 500, 1000, 2000, 5000],
+                        help="numbers of manufacturer specific entries (default: 100 500 1000 2000 5000)")
+    parser.add_argument("--cxx", default=os.environ.get("CXX", "g++"), help="C++ compiler")
+    parser.add_argument("--cxxflags", default="-O2", help="additional compiler flags (default: -O2)")
+    parser.add_argument("--record-size", type=int, default=8, help="sub-entries per record (default: 8)")
+    parser.add_argument("--types", type=eds_generator.parse_type_mix, default=None,
+                        help="weighted data type mix, see eds_generator.py")
+    parser.add_argument("--rpdo", type=int, default=4, help="number of receive PDOs (default: 4)")
+    parser.add_argument("--tpdo", type=int, default=4, help="number of transmit PDOs (default: 4)")
+    parser.add_argument("--seed", type=int, default=0, help="random seed for the generated EDS files")
+    parser.add_argument("--modm-include", action="append", default=[],
+                        help="modm include path for the device variant, can be repeated, "
+                             "the device variant is skipped if not given")
+    parser.add_argument("--output", default="-", help="JSON output file, '-' for stdout")
+    args = parser.parse_args()
+
+    if not args.modm_include:
+        print("No --modm-include given, skipping the device variant", file=sys.stderr)
+
+    results = []
+    with tempfile.TemporaryDirectory(prefix="od_scaling_") as work_dir:
+        for entries in args.sizes:
+            print("Benchmarking {} entries".format(entries), file=sys.stderr)
+            results.append(benchmark(entries, args, Path(work_dir)))
+
+    report = json.dumps({"compiler" : args.cxx, "cxxflags" : args.cxxflags,
+                         "record_size" : args.record_size, "rpdo" : args.rpdo, "tpdo" : args.tpdo,
+                         "results" : results}, indent=2)
+    if args.output == "-":
+        print(report)
+    else:
+        with open(args.output, "w") as out:
+            out.write(report + "\n")
+
+
+if __name__ == "__main__":
+    main()